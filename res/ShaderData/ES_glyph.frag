@@ -1,12 +1,12 @@
 precision mediump float;
 
 varying vec2 texCoords;
+varying vec3 vertexColor;
 
 uniform sampler2D glyph;
-uniform vec3 textColor;
 
 void main()
 {
     vec4 sampled = vec4(1.0, 1.0, 1.0, texture2D(glyph, texCoords).a);
-    gl_FragColor = sampled * vec4(textColor, 1.0);
+    gl_FragColor = sampled * vec4(vertexColor, 1.0);
 }
@@ -1,14 +1,17 @@
 precision mediump float;
 
-attribute /*layout (location = 0) in*/ vec2 pos;
+attribute /*layout (location = 0) in*/ vec2 pos; // in framebuffer pixels, the sprite batch does the positioning
+attribute /*layout (location = 1) in*/ vec2 uv;
+attribute /*layout (location = 2) in*/ vec4 color;
 
 varying vec2 texCoords;
+varying vec3 vertexColor;
 
-uniform mat4 model;
 uniform mat4 projection;
 
 void main()
 {
-    texCoords = pos;
-    gl_Position = projection * model * vec4(pos, 0.0, 1.0);
-}
+    texCoords = uv;
+    vertexColor = color.rgb;
+    gl_Position = projection * vec4(pos, 0.0, 1.0);
+}
\ No newline at end of file
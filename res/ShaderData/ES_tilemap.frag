@@ -0,0 +1,29 @@
+precision mediump float;
+
+varying vec2 texCoords; // 0-1 over the whole grid
+
+uniform sampler2D tiles;      // one texel per cell, channel i is 1 where layer i is drawn
+uniform sampler2D layers[3];  // layer textures, stacked in order
+uniform vec4 layerRects[3];   // where the current frame of each layer is in its texture, xy = top left, zw = size
+uniform vec2 gridSize;
+
+vec4 over(vec4 color, vec4 layer, float mask)
+{
+    float a = layer.a * mask;
+    return vec4(mix(color.rgb, layer.rgb, a), a + color.a * (1.0 - a));
+}
+
+void main()
+{
+    vec2 cellPos = texCoords * gridSize;
+    vec4 cell = texture2D(tiles, (floor(cellPos) + 0.5) / gridSize);
+    vec2 local = fract(cellPos);
+
+    // sampler arrays only take constant indices
+    vec4 color = vec4(0.0);
+    color = over(color, texture2D(layers[0], layerRects[0].xy + local * layerRects[0].zw), cell.r);
+    color = over(color, texture2D(layers[1], layerRects[1].xy + local * layerRects[1].zw), cell.g);
+    color = over(color, texture2D(layers[2], layerRects[2].xy + local * layerRects[2].zw), cell.b);
+
+    gl_FragColor = color;
+}
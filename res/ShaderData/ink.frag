@@ -3,10 +3,16 @@ in vec2 texCoords;
 out vec4 color;
 
 uniform sampler2D image;
-uniform int viewportHeight;
+
+layout (std140) uniform Viewport // shared by every shader, see UniformBuffer
+{
+    mat4 projection;
+    vec2 viewportSize;
+    float time;
+};
 
 void main()
 {
     color = texture(image, texCoords);
-    color.rgb = mix(color.rgb, vec3(0.169,0.271,0.361), gl_FragCoord.y / float(viewportHeight));
+    color.rgb = mix(color.rgb, vec3(0.169,0.271,0.361), gl_FragCoord.y / viewportSize.y);
 }
\ No newline at end of file
@@ -1,13 +1,21 @@
 #version 330 core
-layout (location = 0) in vec2 pos;
+layout (location = 0) in vec2 pos; // in framebuffer pixels, the sprite batch does the positioning
+layout (location = 1) in vec2 uv;
+layout (location = 2) in vec4 color;
 
 out vec2 texCoords;
+out vec3 vertexColor;
 
-uniform mat4 model;
-uniform mat4 projection;
+layout (std140) uniform Viewport // shared by every shader, see UniformBuffer
+{
+    mat4 projection;
+    vec2 viewportSize;
+    float time;
+};
 
 void main()
 {
-    texCoords = pos;
-    gl_Position = projection * model * vec4(pos, 0.0, 1.0);
+    texCoords = uv;
+    vertexColor = color.rgb;
+    gl_Position = projection * vec4(pos, 0.0, 1.0);
 }
\ No newline at end of file
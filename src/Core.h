@@ -65,13 +65,38 @@ inline void win_change_attributes(const int foreground)
 #define CHANGE_COLOR(col) printf("\033[%im", (col))
 #endif
 
+#include <ctime>
 #include <iostream>
+#include <mutex>
 
-#define LOG(...) {auto now = std::chrono::system_clock::now(); \
-    auto in_time_t = std::chrono::system_clock::to_time_t(now); \
-    std::cout << std::put_time(std::localtime(&in_time_t), "[%X] ");\
+// startup tasks log from worker threads, so a line (and its color) is written under this
+inline std::mutex& logMutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+// std::localtime hands out a shared buffer, these fill in ours
+inline std::tm logTime()
+{
+    const std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+    std::tm time{};
+#ifdef PLATFORM_WINDOWS
+    localtime_s(&time, &now);
+#else
+    localtime_r(&now, &time);
+#endif
+    return time;
+}
+
+// one line without taking the lock, for the macros below that already hold it
+#define LOG_LINE(...) {const std::tm logLineTime = logTime(); \
+    std::cout << std::put_time(&logLineTime, "[%X] ");\
     printf(__VA_ARGS__); printf("\n"); }
 
+#define LOG(...) {std::lock_guard<std::mutex> logLock(logMutex()); \
+    LOG_LINE(__VA_ARGS__); }
+
 #ifdef _DEBUG 
 #define LOG_DEBUG(...) loggerQueue.push([args=std::make_tuple(__VA_ARGS__)] { CHANGE_COLOR(35); /* set color to magenta */\
         std::apply(smart_printf{}, args); \
@@ -83,13 +108,16 @@ inline void win_change_attributes(const int foreground)
 #define PROFILE
 #endif
 
-#define LOG_ERROR(...) CHANGE_COLOR(4); /* red error color */\
-        LOG(__VA_ARGS__); \
-        CHANGE_COLOR(0)
+// wrapped so they're one statement, an unbraced if would only cover the color change otherwise
+#define LOG_ERROR(...) do { std::lock_guard<std::mutex> logLock(logMutex()); \
+        CHANGE_COLOR(4); /* red error color */\
+        LOG_LINE(__VA_ARGS__); \
+        CHANGE_COLOR(0); } while (0)
 
-#define LOG_INFO(...) CHANGE_COLOR(34); /* green info color */\
-        LOG(__VA_ARGS__); \
-        CHANGE_COLOR(0)
+#define LOG_INFO(...) do { std::lock_guard<std::mutex> logLock(logMutex()); \
+        CHANGE_COLOR(34); /* green info color */\
+        LOG_LINE(__VA_ARGS__); \
+        CHANGE_COLOR(0); } while (0)
 
 #define DISALLOW_COPY_AND_ASSIGN(TypeName) \
     TypeName(const TypeName&) = delete;   \
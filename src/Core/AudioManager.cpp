@@ -1,20 +1,61 @@
 #include "AudioManager.h"
 
 #include "Util.h"
+#include "Core/FileSystem.h"
 
 void AudioManager::loadSound(const std::string& soundName)
 {
-    auto& [key, wave] = *waves.try_emplace(soundName).first;
-    if (!wave) {
-        wave = std::make_unique<SoLoud::Wav>();
+    const SoundId id = soundId(soundName);
+    if (!id.valid())
+    {
+        LOG_ERROR("Sound %s has to be added before it's loaded!", soundName.c_str());
+        return;
+    }
+
+    Sound& sound = sounds[id];
+
+    std::string path = "res/SoundData/" + soundName + ".ogg";
+
+    auto file = std::make_unique<FileData>();
+    if (!FileSystem::read(path, *file))
+    {
+        LOG_ERROR("Failed to load sound %s!", path.c_str());
+        return;
+    }
+
+    const bool stream = sound.playback == Playback::STREAMED
+        || (sound.playback == Playback::AUTO && file->size() > STREAM_THRESHOLD);
 
-        std::string file = "res/SoundData/" + soundName + ".ogg";
+    SoLoud::result result;
 
-        wave->load(file.c_str()); // load the file
+    if (stream)
+    {
+        // reads straight out of the file while it plays, so the file stays with it
+        auto wavStream = std::make_unique<SoLoud::WavStream>();
+        result = wavStream->loadMem(file->data(), unsigned(file->size()), false, false);
+
+        sound.file = std::move(file);
+        sound.source = std::move(wavStream);
+    }
+    else
+    {
+        // the whole sound gets decoded right here, so it doesn't need to keep the file around
+        auto wave = std::make_unique<SoLoud::Wav>();
+        result = wave->loadMem(file->data(), unsigned(file->size()), false, false);
+
+        sound.source = std::move(wave);
+    }
+
+    if (result != SoLoud::SO_NO_ERROR)
+    {
+        LOG_ERROR("Failed to load sound %s!", path.c_str());
+
+        sound.source.reset();
+        sound.file.reset();
     }
 }
 
-void AudioManager::init(const std::vector<std::string>& sounds)
+void AudioManager::init()
 {
     engine.init(0U, // aFlags
                 0U, // aBackend
@@ -22,46 +63,206 @@ void AudioManager::init(const std::vector<std::string>& sounds)
                 0U, // aBufferSize
                 1U);// aChannels
 
-    for(const std::string& sound : sounds)
-        loadSound(sound);
+#ifndef PLATFORM_WEB
+    audioThread = std::thread([this] { run(); });
+#endif
+}
+
+void AudioManager::addSounds(const std::vector<std::string>& soundNames, Playback playback)
+{
+    for(const std::string& soundName : soundNames)
+    {
+        sounds[sounds.add(soundName)].playback = playback;
+    }
 }
 
 AudioManager::~AudioManager()
 {
+#ifndef PLATFORM_WEB
+    if (audioThread.joinable())
+    {
+        // QUIT can't be dropped, wait for room if it's full
+        while (!commands.push(Command{ Command::Type::QUIT }))
+            std::this_thread::yield();
+
+        audioThread.join();
+    }
+#endif
+
     engine.deinit();
 }
 
-void AudioManager::play(const std::string& soundName, float vol, bool loop)
+void AudioManager::limitVoices(const std::string& soundName, const Voices& limits)
+{
+    const SoundId id = soundId(soundName);
+    if (id.valid())
+        sounds[id].limits = limits;
+}
+
+SoundId AudioManager::soundId(const std::string& soundName) const
 {
-    auto& [key, wave] = *waves.try_emplace(soundName).first;
-    if (!wave) {
-        LOG_ERROR("Sound was played without being pre-loaded! Please add its name to the init call.");
+    const SoundId id = sounds.find(soundName);
+    if (!id.valid())
+    {
+        LOG_ERROR("Sound %s was never added! Please add its name to the addSounds call.", soundName.c_str());
+    }
+
+    return id;
+}
 
-        wave = std::make_unique<SoLoud::Wav>();
+void AudioManager::play(SoundId sound, float vol, bool loop)
+{
+    send(Command{ Command::Type::PLAY, sound, vol, loop });
+}
 
-        std::string file = "res/SoundData/" + soundName + ".ogg";
+void AudioManager::setSoundVolume(SoundId sound, float vol)
+{
+    send(Command{ Command::Type::SET_VOLUME, sound, vol });
+}
+
+void AudioManager::setGlobalVolume(float vol)
+{
+    send(Command{ Command::Type::SET_GLOBAL_VOLUME, NO_SOUND, vol });
+}
+
+void AudioManager::update()
+{
+#ifdef PLATFORM_WEB
+    Command command;
+    while (commands.pop(command))
+        execute(command);
+#endif
+}
 
-        wave->load(file.c_str()); // load the file
+void AudioManager::send(const Command& command)
+{
+    if (command.type != Command::Type::SET_GLOBAL_VOLUME && !command.sound.valid())
+        return; // NO_SOUND, soundId already complained
+
+    if (!commands.push(command))
+    {
+        LOG_ERROR("Audio command queue is full, dropped a command!");
     }
-    
-    wave->setLooping(loop);
+}
+
+void AudioManager::run()
+{
+    while (true)
+    {
+        commands.wait();
 
-    LOG("Playing sound %s", soundName.c_str());
-    handles.insert_or_assign(soundName, engine.play(*wave, vol));
+        Command command;
+        while (commands.pop(command))
+        {
+            if (command.type == Command::Type::QUIT)
+                return;
+
+            execute(command);
+        }
+    }
 }
 
-void AudioManager::setSoundVolume(const std::string& sound, float vol)
+void AudioManager::execute(const Command& command)
 {
-    auto f = handles.find(sound); // <- I'm getting the error here
-    if (f == handles.end()) {
-        LOG_ERROR("Tried to change volume of nonexistent sound \"%s\"!", sound.c_str());
-        return;
+    switch (command.type)
+    {
+    case Command::Type::PLAY:
+    {
+        SoLoud::AudioSource* source = sounds[command.sound].source.get();
+        if (!source)
+            return; // didn't load, that's been logged already
+
+        if (!makeRoom(command.sound))
+            return;
+
+        // streams loop without a gap too, the mixer seeks back and keeps filling the same block
+        source->setLooping(command.loop);
+
+        voices[voiceCount++] = Voice{ engine.play(*source, command.volume), command.sound };
+        break;
     }
 
-    engine.setVolume(f->second, vol);
+    case Command::Type::SET_VOLUME:
+        for (std::size_t i = 0; i < voiceCount; i++)
+        {
+            if (voices[i].sound == command.sound)
+                engine.setVolume(voices[i].handle, command.volume);
+        }
+        break;
+
+    case Command::Type::SET_GLOBAL_VOLUME:
+        engine.setGlobalVolume(command.volume);
+        break;
+
+    case Command::Type::QUIT:
+        break;
+    }
 }
 
-void AudioManager::setGlobalVolume(float vol)
+void AudioManager::pruneVoices()
 {
-    engine.setGlobalVolume(vol);
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < voiceCount; i++)
+    {
+        if (engine.isValidVoiceHandle(voices[i].handle))
+            voices[kept++] = voices[i];
+    }
+
+    voiceCount = kept;
+}
+
+void AudioManager::stopVoice(std::size_t index)
+{
+    engine.stop(voices[index].handle);
+
+    // shifted down rather than swapped, so they stay oldest first
+    for (std::size_t i = index + 1; i < voiceCount; i++)
+        voices[i - 1] = voices[i];
+
+    voiceCount--;
+}
+
+bool AudioManager::makeRoom(SoundId sound)
+{
+    pruneVoices();
+
+    const Voices& limits = sounds[sound].limits;
+
+    std::size_t playing = 0;
+    std::size_t oldest = voiceCount;
+    for (std::size_t i = 0; i < voiceCount; i++)
+    {
+        if (voices[i].sound != sound)
+            continue;
+
+        if (oldest == voiceCount)
+            oldest = i;
+        playing++;
+    }
+
+    if (playing >= limits.max)
+    {
+        if (!limits.retrigger || oldest == voiceCount)
+            return false;
+
+        stopVoice(oldest);
+    }
+
+    if (voiceCount < VOICE_BUDGET)
+        return true;
+
+    // out of voices, take the oldest of the least important ones
+    std::size_t victim = voiceCount;
+    for (std::size_t i = 0; i < voiceCount; i++)
+    {
+        const uint8_t priority = sounds[voices[i].sound].limits.priority;
+        if (priority <= limits.priority && (victim == voiceCount || priority < sounds[voices[victim].sound].limits.priority))
+            victim = i;
+    }
+
+    if (victim == voiceCount)
+        return false;
+
+    stopVoice(victim);
+    return true;
 }
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <array>
+#include <cstdint>
 #include <string>
 #include <unordered_map>
 #include <memory>
@@ -9,24 +11,137 @@
 
 #include "soloud.h"
 #include "soloud_wav.h"
+#include "soloud_wavstream.h"
 
 #include "Core.h"
+#include "Core/FileSystem.h"
+#include "Core/Registry.h"
+#include "Core/SpscQueue.h"
 
+// a sound, from AudioManager::soundId. Look it up once and keep it, playing by id never touches strings
+typedef Handle<struct SoundTag> SoundId;
+
+// sounds are loaded at startup and played from the main thread. Playing one only puts a command on a queue,
+// the audio thread does everything that needs the mixer's lock, so the game never waits on the mixer
 class AudioManager
 {
+public:
+    static constexpr SoundId NO_SOUND{};
+
+    // how a sound is kept in memory. Decoded sounds are PCM up front, streamed ones stay compressed
+    // and the audio thread decodes them bit by bit while they play (and loop without gaps)
+    enum class Playback
+    {
+        AUTO, // streamed if the file is over STREAM_THRESHOLD
+        DECODED,
+        STREAMED
+    };
+
+    // effects are a few KB of ogg, music is megabytes and tens of megabytes as PCM
+    static constexpr std::size_t STREAM_THRESHOLD = 256 * 1024;
+
+    // most voices mixing at once, whatever the input rate. Same as SoLoud's default active voice count,
+    // anything past that would only be tracked and not heard anyway
+    static constexpr std::size_t VOICE_BUDGET = 16;
+
+    // how many copies of a sound can play at once and who wins when there's no room
+    struct Voices
+    {
+        uint8_t max = 4;
+
+        // when the budget is used up, a new voice takes over the oldest one with the lowest priority,
+        // as long as that's no higher than its own. Otherwise the new one doesn't play
+        uint8_t priority = 1;
+
+        // at max, restart by taking over this sound's oldest voice instead of not playing the new one
+        bool retrigger = false;
+    };
+
 private:
+    struct Sound
+    {
+        Playback playback = Playback::AUTO;
+        Voices limits;
+
+        std::unique_ptr<FileData> file; // what a stream reads from, declared first so it outlives the source
+        std::unique_ptr<SoLoud::AudioSource> source; // a Wav or a WavStream, nullptr until loaded
+    };
+
+    struct Command
+    {
+        enum class Type : uint8_t
+        {
+            PLAY,
+            SET_VOLUME,
+            SET_GLOBAL_VOLUME,
+            QUIT
+        };
+
+        Type type;
+        SoundId sound;
+        float volume;
+        bool loop;
+    };
+
+    // audio thread only, runs commands until it gets QUIT
+    void run();
+    void execute(const Command& command);
+
+    // main thread only, drops the command if the audio thread is hopelessly behind
+    void send(const Command& command);
+
     SoLoud::Soloud engine;
-    std::unordered_map<std::string, std::unique_ptr<SoLoud::Wav>> waves;
-    std::unordered_map<std::string, SoLoud::handle> handles;
 
-    void loadSound(const std::string& soundName);
+    // filled in before anything plays and never resized after, so every thread can index it
+    InternedRegistry<Sound, SoundTag> sounds;
+
+    SpscQueue<Command, 256> commands;
+
+    struct Voice
+    {
+        SoLoud::handle handle;
+        SoundId sound;
+    };
+
+    // audio thread only, everything playing, oldest first
+    std::array<Voice, VOICE_BUDGET> voices;
+    std::size_t voiceCount = 0;
+
+    // forgets voices that finished on their own
+    void pruneVoices();
+    void stopVoice(std::size_t index);
+    // makes room for one more voice of this sound, false if it shouldn't play
+    bool makeRoom(SoundId sound);
+
+#ifndef PLATFORM_WEB
+    std::thread audioThread;
+#endif
 public:
     AudioManager() = default;
     ~AudioManager();
 
-    void init(const std::vector<std::string>& sounds = std::vector<std::string>());
-    void play(const std::string& soundName, float vol = 1.0f, bool loop = false);
+    // starts the audio device, and the thread that talks to it
+    void init();
 
-    void setSoundVolume(const std::string& sound, float vol);
+    // makes an empty slot for each sound, so loadSound can fill them in on any thread.
+    // Everything has to be added before anything plays
+    void addSounds(const std::vector<std::string>& soundNames, Playback playback = Playback::AUTO);
+
+    // has to be called before anything plays too
+    void limitVoices(const std::string& soundName, const Voices& limits);
+
+    // loads a sound that was added, different sounds can be loaded at the same time
+    void loadSound(const std::string& soundName);
+
+    // NO_SOUND if it was never added
+    SoundId soundId(const std::string& soundName) const;
+
+    // these only queue the request, call them from the main thread
+    void play(SoundId sound, float vol = 1.0f, bool loop = false);
+
+    void setSoundVolume(SoundId sound, float vol);
     void setGlobalVolume(float vol);
-};
\ No newline at end of file
+
+    // runs queued requests on web, where there's no audio thread. Call once a frame
+    void update();
+};
@@ -0,0 +1,180 @@
+#include "FileSystem.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <unordered_set>
+
+#include "Core/Pak.h"
+
+void FileData::clear()
+{
+    mapped.close();
+    buffer.clear();
+
+    bytes = nullptr;
+    length = 0;
+}
+
+bool FileData::map(const std::string& path)
+{
+    clear();
+
+    if (!mapped.open(path))
+        return false;
+
+    bytes = mapped.data();
+    length = mapped.size();
+    return true;
+}
+
+void FileData::view(const uint8_t* data, std::size_t size)
+{
+    clear();
+
+    bytes = data;
+    length = size;
+}
+
+uint8_t* FileData::allocate(std::size_t size)
+{
+    clear();
+
+    buffer.resize(size);
+
+    bytes = buffer.data();
+    length = size;
+    return buffer.data();
+}
+
+// only touched by mount/unmount, which happen before anything else loads, so reads don't need a lock
+static Pak pak;
+static std::string pakRoot;                           // with a slash on the end
+static std::unordered_set<std::string> looseOverrides; // paths under pakRoot that exist on disk
+
+static std::string normalize(std::string path)
+{
+    std::replace(path.begin(), path.end(), '\\', '/');
+    return path;
+}
+
+// path relative to the pak's root, if the pak could have it
+static bool inPakRoot(const std::string& path, std::string_view& relative)
+{
+    if (!pak.isOpen() || !path.starts_with(pakRoot))
+        return false;
+
+    relative = std::string_view(path).substr(pakRoot.size());
+    return true;
+}
+
+bool FileSystem::mount(const std::string& pakPath, const std::string& root, std::string& error)
+{
+    unmount();
+
+    if (!pak.open(pakPath, error))
+        return false;
+
+    pakRoot = normalize(root) + '/';
+
+    // look for loose files once here instead of checking the disk on every read
+    std::error_code ec;
+    for (auto it = std::filesystem::recursive_directory_iterator(root, ec); !ec && it != std::filesystem::recursive_directory_iterator(); it.increment(ec))
+    {
+        if (it->is_regular_file())
+            looseOverrides.insert(normalize(it->path().string()));
+    }
+
+    LOG_INFO("Mounted %s with %zu files, %zu loose files override it", pakPath.c_str(), pak.size(), looseOverrides.size());
+
+    return true;
+}
+
+void FileSystem::unmount()
+{
+    pak.close();
+    pakRoot.clear();
+    looseOverrides.clear();
+}
+
+bool FileSystem::exists(const std::string& file)
+{
+    const std::string path = normalize(file);
+
+    std::string_view relative;
+    if (inPakRoot(path, relative))
+        return looseOverrides.contains(path) || pak.find(relative) >= 0;
+
+    std::error_code ec;
+    return std::filesystem::is_regular_file(path, ec);
+}
+
+bool FileSystem::read(const std::string& file, FileData& out)
+{
+    const std::string path = normalize(file);
+
+    std::string_view relative;
+    if (inPakRoot(path, relative) && !looseOverrides.contains(path))
+    {
+        int index = pak.find(relative);
+
+        if (index < 0)
+        {
+            out.clear();
+            return false;
+        }
+
+        if (!pak.read(index, out))
+        {
+            LOG_ERROR("%s is corrupt in the pak!", path.c_str());
+            return false;
+        }
+
+        return true;
+    }
+
+    return out.map(path);
+}
+
+std::vector<std::string> FileSystem::list(const std::string& directory)
+{
+    std::string dir = normalize(directory);
+    if (!dir.ends_with('/'))
+        dir += '/';
+
+    std::vector<std::string> files;
+
+    auto directlyInside = [&](std::string_view path)
+    {
+        return path.starts_with(dir) && path.find('/', dir.size()) == std::string_view::npos;
+    };
+
+    std::string_view relative;
+    if (inPakRoot(dir, relative))
+    {
+        for (std::size_t i = 0; i < pak.size(); i++)
+        {
+            std::string path = pakRoot + std::string(pak.path(i));
+
+            if (directlyInside(path))
+                files.push_back(std::move(path));
+        }
+
+        for (const std::string& path : looseOverrides)
+        {
+            if (directlyInside(path) && std::find(files.begin(), files.end(), path) == files.end())
+                files.push_back(path);
+        }
+    } else
+    {
+        std::error_code ec;
+        for (auto it = std::filesystem::directory_iterator(directory, ec); !ec && it != std::filesystem::directory_iterator(); it.increment(ec))
+        {
+            if (it->is_regular_file())
+                files.push_back(normalize(it->path().string()));
+        }
+    }
+
+    std::sort(files.begin(), files.end());
+
+    return files;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Core.h"
+#include "Core/MappedFile.h"
+
+// contents of a file read through the FileSystem. Points straight into the pak or a mapped loose file
+// when it can, and only owns a copy when the file had to be decompressed.
+class FileData
+{
+public:
+    FileData() = default;
+
+    DISALLOW_COPY_AND_ASSIGN(FileData)
+
+    const uint8_t* data() const { return bytes; }
+    std::size_t size() const { return length; }
+
+    std::string_view text() const { return std::string_view((const char*)bytes, length); }
+
+    void clear();
+
+    // ways to fill it in, each one replaces what was there
+    bool map(const std::string& path);
+    void view(const uint8_t* data, std::size_t size); // data has to outlive this
+    uint8_t* allocate(std::size_t size);
+
+private:
+    const uint8_t* bytes = nullptr;
+    std::size_t length = 0;
+
+    MappedFile mapped;
+    std::vector<uint8_t> buffer;
+};
+
+// every read of game files goes through here. With a pak mounted, files under its root come out of the pak,
+// unless there's a loose file with the same path to override it (for mods). Everything else is read from disk.
+namespace FileSystem
+{
+    // mounts a pak built from the folder root, e.g. mount("res.pak", "res") serves "res/ShaderData/crt.vert".
+    // Only one pak at a time, call it before anything is loaded.
+    bool mount(const std::string& pakPath, const std::string& root, std::string& error);
+    void unmount();
+
+    bool exists(const std::string& path);
+    bool read(const std::string& path, FileData& out);
+
+    // files directly inside dir, with dir in front like Util::listFiles
+    std::vector<std::string> list(const std::string& dir);
+}
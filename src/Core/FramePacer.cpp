@@ -0,0 +1,167 @@
+#include "FramePacer.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <thread>
+
+#include "Core.h"
+
+#ifdef PLATFORM_WINDOWS
+// newer than some SDKs we build with, it's Windows 10 1803 and up
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+#endif
+
+FramePacer::FramePacer()
+{
+#ifdef PLATFORM_WINDOWS
+    // older windows doesn't have these, sleep_for it is then and the spin time grows to cover it
+    timer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+#endif
+}
+
+FramePacer::~FramePacer()
+{
+#ifdef PLATFORM_WINDOWS
+    if (timer)
+        CloseHandle(timer);
+#endif
+}
+
+bool FramePacer::parse(const std::string& text, Mode& mode, int& hz)
+{
+    if (text == "vsync")
+    {
+        mode = Mode::VSYNC;
+        return true;
+    }
+
+    if (text == "uncapped")
+    {
+        mode = Mode::UNCAPPED;
+        return true;
+    }
+
+    char* end = nullptr;
+    const long rate = std::strtol(text.c_str(), &end, 10);
+    if (text.empty() || *end != '\0' || rate <= 0 || rate > 1000)
+        return false;
+
+    mode = Mode::FIXED;
+    hz = int(rate);
+    return true;
+}
+
+void FramePacer::setMode(Mode _mode, int hz)
+{
+    mode = _mode;
+    interval = hz > 0 ? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / hz)) : Clock::duration(0);
+
+    restart();
+
+    if (mode == Mode::UNCAPPED)
+        LOG_INFO("Frame rate is uncapped");
+    else if (mode == Mode::FIXED)
+        LOG_INFO("Frame rate is capped to %i fps", hz);
+    else
+        LOG_INFO("Frame rate follows vsync at %i Hz", hz);
+}
+
+void FramePacer::restart()
+{
+    const Clock::time_point now = Clock::now();
+    deadline = now + interval;
+    lastFrame = now;
+    lastReport = now;
+
+    frames = missed = 0;
+    worstMiss = Clock::duration(0);
+}
+
+void FramePacer::endFrame()
+{
+    Clock::time_point now = Clock::now();
+    frames++;
+
+    if (mode == Mode::FIXED)
+    {
+        if (now > deadline)
+        {
+            missed++;
+            worstMiss = std::max(worstMiss, now - deadline);
+
+            // too late to catch up, count from here instead of rushing the next frames
+            deadline = now;
+        }
+        else
+        {
+            if (deadline - now > spinTime)
+            {
+                const Clock::time_point wake = deadline - spinTime;
+                sleepFor(wake - now);
+
+                // a late wake up eats into the spin, so stop sleeping earlier from now on.
+                // it comes back down slowly once the sleeps are on time again
+                const Clock::duration needed = std::max<Clock::duration>(Clock::now() - wake + SPIN_MARGIN, SPIN_TIME);
+                if (needed > spinTime)
+                    spinTime = std::min(needed, interval);
+                else
+                    spinTime -= (spinTime - needed) / 16;
+            }
+
+            while (Clock::now() < deadline)
+                std::this_thread::yield();
+
+            now = Clock::now();
+        }
+
+        deadline += interval;
+    }
+    else if (mode == Mode::VSYNC && interval.count() > 0)
+    {
+        // a frame that took over one and a half refreshes has shown something twice
+        const Clock::duration frameTime = now - lastFrame;
+        if (frameTime > interval + interval / 2)
+        {
+            missed++;
+            worstMiss = std::max(worstMiss, frameTime - interval);
+        }
+    }
+
+    lastFrame = now;
+
+    if (now - lastReport >= REPORT_INTERVAL)
+    {
+        if (missed > 0)
+        {
+            const double seconds = std::chrono::duration<double>(now - lastReport).count();
+            const double worstMillis = std::chrono::duration<double, std::milli>(worstMiss).count();
+            LOG_INFO("Missed %i of %i frame deadlines in the last %.0fs, worst by %.2fms", missed, frames, seconds, worstMillis);
+        }
+
+        lastReport = now;
+        frames = missed = 0;
+        worstMiss = Clock::duration(0);
+    }
+}
+
+void FramePacer::sleepFor(Clock::duration time)
+{
+#ifdef PLATFORM_WINDOWS
+    if (timer)
+    {
+        // negative is relative, in 100ns units
+        LARGE_INTEGER due;
+        due.QuadPart = -LONGLONG(std::chrono::duration_cast<std::chrono::nanoseconds>(time).count() / 100);
+
+        if (SetWaitableTimer(timer, &due, 0, nullptr, nullptr, FALSE))
+        {
+            WaitForSingleObject(timer, INFINITE);
+            return;
+        }
+    }
+#endif
+
+    std::this_thread::sleep_for(time);
+}
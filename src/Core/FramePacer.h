@@ -0,0 +1,67 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+
+// holds frames to a target rate on steady_clock. It sleeps until just before a frame is due and spins the
+// rest of the way, since a sleep can wake up a millisecond or more late. How far ahead it stops sleeping
+// follows how late the sleeps have actually been. Frames that finish past their deadline are counted and
+// logged every few seconds
+class FramePacer
+{
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    FramePacer();
+    ~FramePacer();
+
+    FramePacer(const FramePacer&) = delete;
+    FramePacer& operator=(const FramePacer&) = delete;
+
+    enum class Mode
+    {
+        VSYNC,   // buffer swaps wait for the display, the pacer only watches for missed frames
+        FIXED,   // no vsync, hz frames a second
+        UNCAPPED // no vsync and no waiting, for benchmarking
+    };
+
+    // "vsync", "uncapped" or a number of frames a second, false if it's none of those
+    static bool parse(const std::string& text, Mode& mode, int& hz);
+
+    // hz is the target for FIXED and the display's refresh rate for VSYNC
+    void setMode(Mode _mode, int hz);
+    Mode getMode() const { return mode; }
+
+    // starts counting from now, so time spent before the first frame isn't a missed deadline
+    void restart();
+
+    // call once a frame after it's been presented, waits until the next one should start
+    void endFrame();
+
+private:
+    void sleepFor(Clock::duration time);
+
+    // sleeping stops at least this long before the deadline, the rest is spun
+    static constexpr std::chrono::microseconds SPIN_TIME{ 2000 };
+
+    // kept on top of the worst recent oversleep
+    static constexpr std::chrono::microseconds SPIN_MARGIN{ 500 };
+
+    // missed frames are logged at most this often
+    static constexpr std::chrono::seconds REPORT_INTERVAL{ 5 };
+
+    Mode mode = Mode::VSYNC;
+    Clock::duration interval{ 0 };
+
+    Clock::time_point deadline;
+    Clock::time_point lastFrame;
+    Clock::time_point lastReport;
+
+    int frames = 0;
+    int missed = 0;
+    Clock::duration worstMiss{ 0 };
+
+    Clock::duration spinTime = SPIN_TIME;
+
+    void* timer = nullptr; // high resolution waitable timer on windows, Sleep() only wakes up every 15.6ms
+};
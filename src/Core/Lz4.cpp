@@ -0,0 +1,173 @@
+#include "Lz4.h"
+
+#include <cstring>
+
+static constexpr std::size_t MIN_MATCH = 4;
+static constexpr std::size_t LAST_LITERALS = 5; // the format ends every block with at least this many literals
+static constexpr std::size_t MATCH_LIMIT = 12;  // no match may start closer than this to the end
+static constexpr std::size_t MAX_OFFSET = 65535;
+
+static constexpr int HASH_BITS = 12;
+
+static uint32_t read32(const uint8_t* p)
+{
+    uint32_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+static uint32_t hash4(uint32_t sequence)
+{
+    return (sequence * 2654435761u) >> (32 - HASH_BITS);
+}
+
+static void writeLength(std::vector<uint8_t>& out, std::size_t length)
+{
+    for (; length >= 255; length -= 255)
+        out.push_back(255);
+
+    out.push_back(uint8_t(length));
+}
+
+std::vector<uint8_t> Lz4::compress(const uint8_t* src, std::size_t size)
+{
+    std::vector<uint8_t> out;
+    out.reserve(compressBound(size));
+
+    uint32_t table[1 << HASH_BITS] = {};
+
+    std::size_t anchor = 0; // start of the literals not written yet
+    std::size_t pos = 0;
+
+    auto emit = [&](std::size_t matchOffset, std::size_t matchLength)
+    {
+        const std::size_t literals = pos - anchor;
+
+        const std::size_t tokenIndex = out.size();
+        out.push_back(0); // filled in once both lengths are known
+
+        uint8_t literalBits = uint8_t(literals >= 15 ? 15 : literals);
+        if (literals >= 15)
+            writeLength(out, literals - 15);
+
+        out.insert(out.end(), src + anchor, src + pos);
+
+        uint8_t matchBits = 0;
+        if (matchLength != 0)
+        {
+            out.push_back(uint8_t(matchOffset));
+            out.push_back(uint8_t(matchOffset >> 8));
+
+            std::size_t extra = matchLength - MIN_MATCH;
+            matchBits = uint8_t(extra >= 15 ? 15 : extra);
+            if (extra >= 15)
+                writeLength(out, extra - 15);
+        }
+
+        out[tokenIndex] = uint8_t(literalBits << 4 | matchBits);
+    };
+
+    if (size > MATCH_LIMIT)
+    {
+        const std::size_t matchEnd = size - LAST_LITERALS;
+        const std::size_t searchEnd = size - MATCH_LIMIT;
+
+        while (pos < searchEnd)
+        {
+            const uint32_t sequence = read32(src + pos);
+            uint32_t& slot = table[hash4(sequence)];
+
+            const std::size_t candidate = slot;
+            slot = uint32_t(pos);
+
+            if (candidate >= pos || pos - candidate > MAX_OFFSET || read32(src + candidate) != sequence)
+            {
+                pos++;
+                continue;
+            }
+
+            std::size_t length = MIN_MATCH;
+            while (pos + length < matchEnd && src[candidate + length] == src[pos + length])
+                length++;
+
+            emit(pos - candidate, length);
+
+            pos += length;
+            anchor = pos;
+        }
+    }
+
+    pos = size;
+    emit(0, 0);
+
+    return out;
+}
+
+bool Lz4::decompress(const uint8_t* src, std::size_t srcSize, uint8_t* dst, std::size_t dstSize)
+{
+    std::size_t in = 0;
+    std::size_t out = 0;
+
+    auto readLength = [&](std::size_t& length)
+    {
+        uint8_t byte;
+        do
+        {
+            if (in >= srcSize)
+                return false;
+
+            byte = src[in++];
+            length += byte;
+        } while (byte == 255);
+
+        return true;
+    };
+
+    while (in < srcSize)
+    {
+        const uint8_t token = src[in++];
+
+        std::size_t literals = token >> 4;
+        if (literals == 15 && !readLength(literals))
+            return false;
+
+        if (literals > srcSize - in || literals > dstSize - out)
+            return false;
+
+        memcpy(dst + out, src + in, literals);
+        in += literals;
+        out += literals;
+
+        if (in == srcSize) // the last sequence has no match
+            break;
+
+        if (srcSize - in < 2)
+            return false;
+
+        const std::size_t offset = src[in] | src[in + 1] << 8;
+        in += 2;
+
+        std::size_t length = token & 15;
+        if (length == 15 && !readLength(length))
+            return false;
+        length += MIN_MATCH;
+
+        if (offset == 0 || offset > out || length > dstSize - out)
+            return false;
+
+        // matches can overlap what they're copying, so this has to go byte by byte when they're close
+        const uint8_t* match = dst + out - offset;
+        if (offset >= length)
+        {
+            memcpy(dst + out, match, length);
+        } else
+        {
+            for (std::size_t i = 0; i < length; i++)
+                dst[out + i] = match[i];
+        }
+
+        out += length;
+    }
+
+    return out == dstSize;
+}
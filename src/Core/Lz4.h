@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// LZ4 block format (https://github.com/lz4/lz4/blob/dev/doc/lz4_Block_format.md), small enough to not need the library.
+// The compressor is the simple greedy one, it's only run by the pak tool. Decompressing is what has to be fast.
+namespace Lz4
+{
+    // worst case size of compressing size bytes
+    constexpr std::size_t compressBound(std::size_t size)
+    {
+        return size + size / 255 + 16;
+    }
+
+    std::vector<uint8_t> compress(const uint8_t* src, std::size_t size);
+
+    // dst must be exactly the decompressed size. Returns false if src is corrupt instead of reading or writing out of bounds.
+    bool decompress(const uint8_t* src, std::size_t srcSize, uint8_t* dst, std::size_t dstSize);
+}
@@ -0,0 +1,123 @@
+#include "MappedFile.h"
+
+#if defined(PLATFORM_WEB)
+#include <fstream>
+#elif !defined(PLATFORM_WINDOWS)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+bool MappedFile::open(const std::string& path)
+{
+    close();
+
+#if defined(PLATFORM_WINDOWS)
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize))
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    length = std::size_t(fileSize.QuadPart);
+    fileHandle = file;
+
+    // can't map an empty file, but it's still a file
+    if (length > 0)
+    {
+        mappingHandle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mappingHandle)
+        {
+            close();
+            return false;
+        }
+
+        bytes = (const uint8_t*)MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+        if (!bytes)
+        {
+            close();
+            return false;
+        }
+    }
+#elif defined(PLATFORM_WEB)
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        return false;
+
+    buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+    bytes = buffer.data();
+    length = buffer.size();
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0)
+    {
+        ::close(fd);
+        return false;
+    }
+
+    length = std::size_t(info.st_size);
+
+    // can't map an empty file, but it's still a file
+    if (length > 0)
+    {
+        void* mapped = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (mapped == MAP_FAILED)
+        {
+            ::close(fd);
+            length = 0;
+            return false;
+        }
+
+        bytes = (const uint8_t*)mapped;
+    }
+
+    ::close(fd); // the mapping keeps the file alive
+#endif
+
+    opened = true;
+    return true;
+}
+
+void MappedFile::close()
+{
+#if defined(PLATFORM_WINDOWS)
+    if (bytes)
+        UnmapViewOfFile(bytes);
+
+    if (mappingHandle)
+        CloseHandle(mappingHandle);
+
+    if (fileHandle)
+        CloseHandle(fileHandle);
+
+    fileHandle = nullptr;
+    mappingHandle = nullptr;
+#elif defined(PLATFORM_WEB)
+    buffer.clear();
+    buffer.shrink_to_fit();
+#else
+    if (bytes)
+        munmap((void*)bytes, length);
+#endif
+
+    bytes = nullptr;
+    length = 0;
+    opened = false;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Core.h"
+
+// read-only view of a whole file. Memory mapped on desktop so only the pages we touch get loaded,
+// read into memory on web where there's nothing to map.
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    DISALLOW_COPY_AND_ASSIGN(MappedFile)
+
+    bool open(const std::string& path);
+    void close();
+
+    bool isOpen() const { return opened; }
+
+    const uint8_t* data() const { return bytes; }
+    std::size_t size() const { return length; }
+
+private:
+    bool opened = false;
+
+    const uint8_t* bytes = nullptr;
+    std::size_t length = 0;
+
+#if defined(PLATFORM_WINDOWS)
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#elif defined(PLATFORM_WEB)
+    std::vector<uint8_t> buffer;
+#endif
+};
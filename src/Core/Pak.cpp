@@ -0,0 +1,224 @@
+#include "Pak.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#include "Core/FileSystem.h"
+#include "Core/Lz4.h"
+
+static constexpr std::size_t DATA_ALIGNMENT = 16;
+
+bool Pak::open(const std::string& path, std::string& error)
+{
+    close();
+
+    if (!file.open(path))
+    {
+        error = "can't open " + path;
+        return false;
+    }
+
+    const uint8_t* bytes = file.data();
+    const std::size_t size = file.size();
+
+    auto fail = [&](const std::string& why)
+    {
+        error = path + ": " + why;
+        file.close();
+        return false;
+    };
+
+    if (size < sizeof(PakHeader))
+        return fail("too small to be a pak");
+
+    const auto* head = (const PakHeader*)bytes;
+
+    if (memcmp(head->magic, MAGIC, sizeof(MAGIC)) != 0)
+        return fail("not a pak");
+
+    if (head->version != VERSION)
+        return fail("unsupported pak version " + std::to_string(head->version));
+
+    if (head->fileSize != size)
+        return fail("file is " + std::to_string(size) + " bytes, expected " + std::to_string(head->fileSize));
+
+    if (head->entryCount > (size - sizeof(PakHeader)) / sizeof(PakEntry))
+        return fail("entry table doesn't fit in the file");
+
+    const auto* table = (const PakEntry*)(bytes + sizeof(PakHeader));
+
+    auto inside = [&](uint64_t offset, uint64_t length)
+    {
+        return offset <= size && length <= size - offset;
+    };
+
+    std::string_view previous;
+
+    for (uint32_t i = 0; i < head->entryCount; i++)
+    {
+        const PakEntry& entry = table[i];
+
+        if (!inside(entry.pathOffset, entry.pathLength) || !inside(entry.dataOffset, entry.storedSize))
+            return fail("entry " + std::to_string(i) + " points outside of the file");
+
+        if (!(entry.flags & FLAG_LZ4) && entry.storedSize != entry.size)
+            return fail("entry " + std::to_string(i) + " has the wrong size");
+
+        // find() is a binary search, so the order has to be right
+        std::string_view entryPath((const char*)bytes + entry.pathOffset, entry.pathLength);
+        if (i > 0 && !(previous < entryPath))
+            return fail("entries aren't sorted");
+
+        previous = entryPath;
+    }
+
+    header = head;
+    entries = table;
+
+    return true;
+}
+
+void Pak::close()
+{
+    header = nullptr;
+    entries = nullptr;
+
+    file.close();
+}
+
+std::string_view Pak::path(std::size_t index) const
+{
+    const PakEntry& entry = entries[index];
+    return std::string_view((const char*)file.data() + entry.pathOffset, entry.pathLength);
+}
+
+int Pak::find(std::string_view wanted) const
+{
+    std::size_t low = 0;
+    std::size_t high = size();
+
+    while (low < high)
+    {
+        std::size_t mid = (low + high) / 2;
+        std::string_view midPath = path(mid);
+
+        if (midPath == wanted)
+            return int(mid);
+
+        if (midPath < wanted)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+
+    return -1;
+}
+
+bool Pak::read(std::size_t index, FileData& out) const
+{
+    const PakEntry& entry = entries[index];
+    const uint8_t* stored = file.data() + entry.dataOffset;
+
+    if (!(entry.flags & FLAG_LZ4))
+    {
+        out.view(stored, entry.size);
+        return true;
+    }
+
+    uint8_t* dst = out.allocate(entry.size);
+
+    if (!Lz4::decompress(stored, entry.storedSize, dst, entry.size))
+    {
+        out.clear();
+        return false;
+    }
+
+    return true;
+}
+
+bool Pak::write(const std::string& path, std::vector<Source> sources, bool compress, std::string& error)
+{
+    std::sort(sources.begin(), sources.end(), [](const Source& a, const Source& b)
+    {
+        return a.path < b.path;
+    });
+
+    for (std::size_t i = 1; i < sources.size(); i++)
+    {
+        if (sources[i].path == sources[i - 1].path)
+        {
+            error = "two files called " + sources[i].path;
+            return false;
+        }
+    }
+
+    std::vector<uint8_t> out(sizeof(PakHeader) + sources.size() * sizeof(PakEntry));
+    std::vector<PakEntry> table(sources.size());
+
+    for (std::size_t i = 0; i < sources.size(); i++)
+    {
+        table[i].pathOffset = uint32_t(out.size());
+        table[i].pathLength = uint32_t(sources[i].path.size());
+
+        out.insert(out.end(), sources[i].path.begin(), sources[i].path.end());
+    }
+
+    for (std::size_t i = 0; i < sources.size(); i++)
+    {
+        const std::vector<uint8_t>& data = sources[i].data;
+
+        if (data.size() > UINT32_MAX)
+        {
+            error = sources[i].path + " is too big for a pak";
+            return false;
+        }
+
+        out.resize((out.size() + DATA_ALIGNMENT - 1) & ~(DATA_ALIGNMENT - 1));
+
+        table[i].dataOffset = uint32_t(out.size());
+        table[i].size = uint32_t(data.size());
+
+        std::vector<uint8_t> packed;
+        if (compress)
+            packed = Lz4::compress(data.data(), data.size());
+
+        if (compress && packed.size() < data.size() - data.size() / 8)
+        {
+            table[i].flags = FLAG_LZ4;
+            table[i].storedSize = uint32_t(packed.size());
+            out.insert(out.end(), packed.begin(), packed.end());
+        } else
+        {
+            table[i].storedSize = uint32_t(data.size());
+            out.insert(out.end(), data.begin(), data.end());
+        }
+    }
+
+    if (out.size() > UINT32_MAX)
+    {
+        error = "pak would be bigger than 4GB";
+        return false;
+    }
+
+    PakHeader head{};
+    memcpy(head.magic, MAGIC, sizeof(MAGIC));
+    head.version = VERSION;
+    head.entryCount = uint32_t(sources.size());
+    head.fileSize = uint32_t(out.size());
+
+    memcpy(out.data(), &head, sizeof(head));
+    if (!table.empty())
+        memcpy(out.data() + sizeof(head), table.data(), table.size() * sizeof(PakEntry));
+
+    std::ofstream file(path, std::ios::binary);
+    file.write((const char*)out.data(), std::streamsize(out.size()));
+
+    if (!file)
+    {
+        error = "can't write " + path;
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Core/MappedFile.h"
+
+class FileData;
+
+// a pak (.pak) is a whole folder of game files in one file, mapped once at startup instead of opening
+// hundreds of files. Layout, little endian:
+//   PakHeader
+//   PakEntry[entryCount], sorted by path so lookups are a binary search
+//   paths, then file data aligned to 16 bytes, found by offset from the start of the file
+// Entries can be LZ4 compressed, the pak tool only does it when it actually saves space.
+
+struct PakHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t fileSize;
+};
+
+struct PakEntry
+{
+    uint32_t pathOffset;
+    uint32_t pathLength;
+
+    uint32_t dataOffset;
+    uint32_t storedSize; // size in the pak
+    uint32_t size;       // size once decompressed
+
+    uint32_t flags;
+};
+
+static_assert(sizeof(PakHeader) == 16);
+static_assert(sizeof(PakEntry) == 24);
+
+class Pak
+{
+public:
+    static constexpr char MAGIC[4] = { 'O', 'P', 'A', 'K' };
+    static constexpr uint32_t VERSION = 1;
+
+    static constexpr uint32_t FLAG_LZ4 = 1;
+
+    // maps the pak and checks that every entry stays inside the file
+    bool open(const std::string& path, std::string& error);
+    void close();
+
+    bool isOpen() const { return header != nullptr; }
+    std::size_t size() const { return header ? header->entryCount : 0; }
+
+    // index of the entry with this path (relative to the folder the pak was built from), or -1
+    int find(std::string_view path) const;
+
+    std::string_view path(std::size_t index) const;
+
+    // uncompressed entries are handed out in place, compressed ones get decompressed into out
+    bool read(std::size_t index, FileData& out) const;
+
+    struct Source
+    {
+        std::string path; // relative, with forward slashes
+        std::vector<uint8_t> data;
+    };
+
+    // used by the pak tool. Entries that don't shrink by at least an eighth are stored as they are.
+    static bool write(const std::string& path, std::vector<Source> sources, bool compress, std::string& error);
+
+private:
+    MappedFile file;
+
+    const PakHeader* header = nullptr;
+    const PakEntry* entries = nullptr;
+};
@@ -1,16 +1,19 @@
 #pragma once
+#include <cstdint>
+#include <string>
 #include <unordered_map>
+#include <vector>
 
 template<typename T, typename H>
 class Registry
 {
 public:
-    inline void add(T key, H value)
+    inline void add(const T& key, H value)
     {
         reg.insert(std::pair<T, H>(key, value));
     }
 
-    H* get(T key)
+    H* get(const T& key)
     {
         auto found = reg.find(key);
 
@@ -20,7 +23,17 @@ public:
         return &found->second;
     }
 
-    bool has(T key)
+    const H* get(const T& key) const
+    {
+        auto found = reg.find(key);
+
+        if (found == reg.end())
+            return nullptr;
+
+        return &found->second;
+    }
+
+    bool has(const T& key) const
     {
         auto found = reg.find(key);
 
@@ -29,3 +42,112 @@ public:
 private:
     std::unordered_map<T, H> reg;
 };
+
+// a name that's been interned, it's just its index. Tag keeps handles of different kinds of things apart
+template<typename Tag>
+class Handle
+{
+public:
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    constexpr Handle() = default;
+    constexpr explicit Handle(uint32_t _index) : index(_index) {}
+
+    constexpr bool valid() const { return index != NONE; }
+
+    constexpr bool operator==(const Handle& h) const = default;
+
+    uint32_t index = NONE;
+};
+
+// hands out a dense handle for every name it's given, the same one every time for the same name.
+// Names are only hashed when they're interned or looked up, so keep the handles around instead of the names
+template<typename Tag>
+class Interner
+{
+public:
+    Handle<Tag> intern(const std::string& name)
+    {
+        if (const Handle<Tag>* found = ids.get(name))
+            return *found;
+
+        const Handle<Tag> handle(uint32_t(names.size()));
+        ids.add(name, handle);
+        names.push_back(name);
+
+        return handle;
+    }
+
+    // an invalid handle if it was never interned
+    Handle<Tag> find(const std::string& name) const
+    {
+        const Handle<Tag>* found = ids.get(name);
+
+        return found ? *found : Handle<Tag>();
+    }
+
+    const std::string& name(Handle<Tag> handle) const
+    {
+        return names[handle.index];
+    }
+
+    std::size_t size() const
+    {
+        return names.size();
+    }
+private:
+    Registry<std::string, Handle<Tag>> ids;
+    std::vector<std::string> names;
+};
+
+// a Registry keyed by interned names, a handle indexes straight into the values.
+// Values move when more are added, so hold on to handles and not references
+template<typename H, typename Tag>
+class InternedRegistry
+{
+public:
+    typedef Handle<Tag> Id;
+
+    // the handle name already has, or a new one with a default constructed value
+    Id add(const std::string& name)
+    {
+        const Id id = names.intern(name);
+        if (id.index == values.size())
+            values.emplace_back();
+
+        return id;
+    }
+
+    Id find(const std::string& name) const
+    {
+        return names.find(name);
+    }
+
+    const std::string& name(Id id) const
+    {
+        return names.name(id);
+    }
+
+    H& operator[](Id id)
+    {
+        return values[id.index];
+    }
+
+    const H& operator[](Id id) const
+    {
+        return values[id.index];
+    }
+
+    std::size_t size() const
+    {
+        return values.size();
+    }
+
+    auto begin() { return values.begin(); }
+    auto end() { return values.end(); }
+    auto begin() const { return values.begin(); }
+    auto end() const { return values.end(); }
+private:
+    Interner<Tag> names;
+    std::vector<H> values;
+};
@@ -0,0 +1,180 @@
+#include "BakedFont.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+
+bool BakedFont::open(const std::string& path, std::string& error)
+{
+    close();
+
+    if (!FileSystem::read(path, file))
+    {
+        error = "can't open " + path;
+        return false;
+    }
+
+    const uint8_t* bytes = file.data();
+    const std::size_t size = file.size();
+
+    auto fail = [&](const std::string& why)
+    {
+        error = path + ": " + why;
+        file.clear();
+        return false;
+    };
+
+    if (size < sizeof(BakedFontHeader))
+        return fail("too small to be a baked font");
+
+    const auto* head = (const BakedFontHeader*)bytes;
+
+    if (memcmp(head->magic, MAGIC, sizeof(MAGIC)) != 0)
+        return fail("not a baked font");
+
+    if (head->version != VERSION)
+        return fail("unsupported baked font version " + std::to_string(head->version));
+
+    if (head->fileSize != size)
+        return fail("file is " + std::to_string(size) + " bytes, expected " + std::to_string(head->fileSize));
+
+    if (head->pageSize == 0 || head->pageSize > 4096)
+        return fail("bad page size " + std::to_string(head->pageSize));
+
+    const uint64_t expected = sizeof(BakedFontHeader) + uint64_t(head->glyphCount) * sizeof(BakedGlyph)
+                            + uint64_t(head->pageSize) * head->pageSize;
+    if (expected != size)
+        return fail("glyph table and page don't add up to the file size");
+
+    const auto* table = (const BakedGlyph*)(bytes + sizeof(BakedFontHeader));
+
+    for (uint32_t i = 0; i < head->glyphCount; i++)
+    {
+        const BakedGlyph& glyph = table[i];
+
+        if (uint32_t(glyph.x) + glyph.width > head->pageSize || uint32_t(glyph.y) + glyph.height > head->pageSize)
+            return fail("glyph " + std::to_string(i) + " is off the page");
+    }
+
+    header = head;
+    glyphs = table;
+
+    return true;
+}
+
+void BakedFont::close()
+{
+    header = nullptr;
+    glyphs = nullptr;
+
+    file.clear();
+}
+
+bool BakedFont::write(const std::string& path, std::vector<Source> sources, std::string& error)
+{
+    // tallest first packs shelves a lot tighter
+    std::vector<std::size_t> order(sources.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b)
+    {
+        return sources[a].height > sources[b].height;
+    });
+
+    std::vector<BakedGlyph> table(sources.size());
+
+    // same shelf packing as TextureAtlas, growing the page until everything fits
+    int pageSize = 64;
+    for (;; pageSize *= 2)
+    {
+        if (pageSize > 4096)
+        {
+            error = "glyphs don't fit on a 4096x4096 page";
+            return false;
+        }
+
+        int shelfX = 0, shelfY = 0, shelfHeight = 0;
+        bool fits = true;
+
+        for (std::size_t i : order)
+        {
+            const Source& source = sources[i];
+
+            const int paddedWidth = source.width + 2 * PADDING;
+            const int paddedHeight = source.height + 2 * PADDING;
+
+            if (shelfX + paddedWidth > pageSize)
+            {
+                shelfY += shelfHeight;
+                shelfX = 0;
+                shelfHeight = 0;
+            }
+
+            if (paddedWidth > pageSize || shelfY + paddedHeight > pageSize)
+            {
+                fits = false;
+                break;
+            }
+
+            BakedGlyph& glyph = table[i];
+            glyph.code = source.code;
+            glyph.x = uint16_t(shelfX + PADDING);
+            glyph.y = uint16_t(shelfY + PADDING);
+            glyph.width = uint16_t(source.width);
+            glyph.height = uint16_t(source.height);
+            glyph.bearingX = int16_t(source.bearingX);
+            glyph.bearingY = int16_t(source.bearingY);
+            glyph.advance = source.advance;
+
+            shelfX += paddedWidth;
+            shelfHeight = std::max(shelfHeight, paddedHeight);
+        }
+
+        if (fits)
+            break;
+    }
+
+    std::vector<uint8_t> page(std::size_t(pageSize) * pageSize, 0);
+
+    for (std::size_t i = 0; i < sources.size(); i++)
+    {
+        const Source& source = sources[i];
+        const BakedGlyph& glyph = table[i];
+
+        if (source.width == 0 || source.height == 0)
+            continue;
+
+        // copy with the edges repeated into the padding
+        for (int py = -PADDING; py < source.height + PADDING; py++)
+        {
+            const int srcY = std::clamp(py, 0, source.height - 1);
+
+            for (int px = -PADDING; px < source.width + PADDING; px++)
+            {
+                const int srcX = std::clamp(px, 0, source.width - 1);
+
+                page[std::size_t(glyph.y + py) * pageSize + (glyph.x + px)] = source.bitmap[std::size_t(srcY) * source.width + srcX];
+            }
+        }
+    }
+
+    BakedFontHeader head{};
+    memcpy(head.magic, MAGIC, sizeof(MAGIC));
+    head.version = VERSION;
+    head.glyphCount = uint32_t(table.size());
+    head.pageSize = uint32_t(pageSize);
+    head.fileSize = uint32_t(sizeof(head) + table.size() * sizeof(BakedGlyph) + page.size());
+
+    std::ofstream file(path, std::ios::binary);
+    file.write((const char*)&head, sizeof(head));
+    file.write((const char*)table.data(), std::streamsize(table.size() * sizeof(BakedGlyph)));
+    file.write((const char*)page.data(), std::streamsize(page.size()));
+
+    if (!file)
+    {
+        error = "can't write " + path;
+        return false;
+    }
+
+    return true;
+}
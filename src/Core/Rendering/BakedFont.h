@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Core/FileSystem.h"
+
+// a baked font (.ofa) is the game's glyphs rasterised at build time onto one atlas page, so startup
+// doesn't need FreeType at all. Layout, little endian:
+//   BakedFontHeader
+//   BakedGlyph[glyphCount]
+//   pageSize * pageSize bytes of coverage, one byte per pixel, row by row from the top
+// Glyphs have their edge pixels repeated into a PADDING wide border like TextureAtlas does.
+
+struct BakedFontHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t glyphCount;
+    uint32_t pageSize;
+    uint32_t fileSize;
+};
+
+struct BakedGlyph
+{
+    uint32_t code;          // the character
+    uint16_t x, y;          // top left on the page, padding not included
+    uint16_t width, height;
+    int16_t bearingX;       // offset from the pen position to the left of the bitmap
+    int16_t bearingY;       // offset from the baseline to the top of the bitmap
+    int32_t advance;        // 26.6 fixed point like FreeType
+};
+
+static_assert(sizeof(BakedFontHeader) == 20);
+static_assert(sizeof(BakedGlyph) == 20);
+
+class BakedFont
+{
+public:
+    static constexpr char MAGIC[4] = { 'O', 'F', 'N', 'T' };
+    static constexpr uint32_t VERSION = 1;
+
+    static constexpr int PADDING = 1;
+
+    // the font and the glyphs the game uses, baked by the font baker and rasterised live if there's no baked font
+    static constexpr const char* FONT_PATH = "res/ObjectData/UI/octopuzzlerType.otf";
+    static constexpr const char* BAKED_PATH = "res/ObjectData/UI/octopuzzlerType.ofa";
+    static constexpr int PIXEL_SIZE = 48;
+    static constexpr std::string_view GLYPHS = "abcdefghijklmnopqrstuvwxyz0123456789 /*,()^_<>#$%&";
+
+    // reads the font through the FileSystem and checks every glyph is on the page
+    bool open(const std::string& path, std::string& error);
+    void close();
+
+    bool isOpen() const { return header != nullptr; }
+    std::size_t size() const { return header ? header->glyphCount : 0; }
+
+    const BakedGlyph& glyph(std::size_t index) const { return glyphs[index]; }
+
+    int pageSize() const { return int(header->pageSize); }
+    const uint8_t* pixels() const { return (const uint8_t*)(glyphs + header->glyphCount); }
+
+    struct Source
+    {
+        uint32_t code;
+        int width, height;
+        int bearingX, bearingY;
+        int advance;
+        std::vector<uint8_t> bitmap; // width * height coverage
+    };
+
+    // packs the glyphs onto the smallest square page they fit on, used by the font baker tool
+    static bool write(const std::string& path, std::vector<Source> sources, std::string& error);
+
+private:
+    FileData file;
+
+    const BakedFontHeader* header = nullptr;
+    const BakedGlyph* glyphs = nullptr;
+};
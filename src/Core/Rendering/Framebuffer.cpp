@@ -1,6 +1,7 @@
 #include "Framebuffer.h"
 
 #include "Outrospection.h"
+#include "GLState.h"
 #include "Util.h"
 
 Framebuffer::Framebuffer(int width, int height) : isDefaultFramebuffer(false),
@@ -11,10 +12,14 @@ Framebuffer::Framebuffer(int width, int height) : isDefaultFramebuffer(false),
 
 void Framebuffer::bind()
 {
-    glBindFramebuffer(GL_FRAMEBUFFER, id);
+    auto& o = Outrospection::get();
+
+    // whatever's queued belongs to the old framebuffer
+    o.spriteBatch.flush();
+
+    GLState::bindFramebuffer(id);
 
 
-    auto& o = Outrospection::get();
     if (isDefaultFramebuffer) // default fb letterboxing
     {
         glm::ivec2 windowRes = o.getWindowResolution();
@@ -47,6 +52,9 @@ void Framebuffer::bind()
 
     const glm::mat4 projection = glm::ortho(0.0f, float(resolution.x), float(resolution.y),
                                             0.0f, -1.0f, 1.0f);
+
+#ifdef PLATFORM_WEB
+    // no uniform buffers on ES2, every shader gets its own copy
     o.spriteShader.use();
     o.spriteShader.setMat4("projection", projection);
 
@@ -56,11 +64,17 @@ void Framebuffer::bind()
 
     o.glyphShader.use();
     o.glyphShader.setMat4("projection", projection);
+
+    o.tilemapShader.use();
+    o.tilemapShader.setMat4("projection", projection);
+#else
+    o.viewportUniforms.update({ projection, glm::vec2(resolution), float(glfwGetTime()), 0.0f });
+#endif
 }
 
 void Framebuffer::bindTexture()
 {
-    glBindTexture(GL_TEXTURE_2D, texId);
+    GLState::bindTexture(texId);
 }
 
 void Framebuffer::scaleResolution(float scale)
@@ -73,11 +87,11 @@ void Framebuffer::scaleResolution(float scale)
         return;
     
     glGenFramebuffers(1, &id);
-    glBindFramebuffer(GL_FRAMEBUFFER, id);
+    GLState::bindFramebuffer(id);
 
     // create color attachment texture
     glGenTextures(1, &texId);
-    glBindTexture(GL_TEXTURE_2D, texId);
+    GLState::bindTexture(texId);
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, resolution.x, resolution.y, 0, GL_RGB, GL_UNSIGNED_BYTE, nullptr);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
@@ -112,5 +126,5 @@ void Framebuffer::scaleResolution(float scale)
         abort();
     }
     
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    GLState::bindFramebuffer(0);
 }
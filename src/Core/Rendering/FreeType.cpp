@@ -2,94 +2,147 @@
 
 #include "Core.h"
 #include "Util.h"
+#include "Core/FileSystem.h"
+#include "Core/Rendering/BakedFont.h"
+#include "Core/Rendering/GLState.h"
 
 FreeType::FreeType()
 {
-    FT_Library ft;
-    if (FT_Init_FreeType(&ft))
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1); // disable byte-alignment restriction
+
+    if (loadBaked())
     {
-        LOG_ERROR("Failed to initialize FreeType!");
+        LOG_INFO("FreeType init DONE! (baked font)");
         return;
     }
 
-    FT_Face face;
-    if (FT_New_Face(ft, "res/ObjectData/UI/octopuzzlerType.otf", 0, &face))
-    {
-        LOG_ERROR("Failed to load res/ObjectData/UI/octopuzzlerType.otf!");
+    if (!openFace())
         return;
+
+    for (char c : BakedFont::GLYPHS)
+        loadChar(c);
+
+    Util::glError();
+    LOG_INFO("FreeType init DONE!");
+}
+
+const FontCharacter* FreeType::getCharacter(char c)
+{
+    auto it = loadedCharacters.find(c);
+    if (it != loadedCharacters.end())
+        return &it->second;
+
+    if (!openFace())
+        return nullptr;
+
+    loadChar(c);
+
+    it = loadedCharacters.find(c);
+    return it != loadedCharacters.end() ? &it->second : nullptr;
+}
+
+bool FreeType::loadBaked()
+{
+    if (!Util::fileExists(BakedFont::BAKED_PATH))
+    {
+        LOG_INFO("No baked font, rasterising glyphs with FreeType");
+        return false;
     }
 
-    FT_Set_Pixel_Sizes(face, 0, 48);
+    BakedFont font;
+    std::string error;
+    if (!font.open(BakedFont::BAKED_PATH, error))
+    {
+        LOG_ERROR("Baked font is broken, rasterising glyphs with FreeType: %s", error.c_str());
+        return false;
+    }
 
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 1); // disable byte-alignment restriction
+    const int pageSize = font.pageSize();
+
+    GLuint texture;
+    glGenTextures(1, &texture);
+    GLState::bindTexture(texture);
+
+    glTexImage2D(GL_TEXTURE_2D, 0, GLYPH_FORMAT, pageSize, pageSize, 0, GLYPH_FORMAT, GL_UNSIGNED_BYTE, font.pixels());
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    for (std::size_t i = 0; i < font.size(); i++)
+    {
+        const BakedGlyph& glyph = font.glyph(i);
+        const bool empty = glyph.width == 0 || glyph.height == 0;
+
+        FontCharacter character = {
+            empty ? 0 : texture,
+            glm::vec4(glyph.x, glyph.y, glyph.width, glyph.height) / float(pageSize),
+            glm::ivec2(glyph.width, glyph.height),
+            glm::ivec2(glyph.bearingX, glyph.bearingY),
+            glyph.advance
+        };
+
+        loadedCharacters.insert(std::pair<char, FontCharacter>(char(glyph.code), character));
+    }
 
     Util::glError();
-    LOG_INFO("FreeType glPixelStorei init DONE!");
+    return true;
+}
 
-    for (unsigned char c = 'a'; c < 'a' + 26; c++)
-        loadChar(face, c);
+bool FreeType::openFace()
+{
+    if (face)
+        return true;
 
-    for (unsigned char c = '0'; c <= '9'; c++) // haha
-        loadChar(face, c);
+    if (faceFailed)
+        return false;
 
-    loadChar(face, ' ');
-    loadChar(face, '/');
+    faceFailed = true; // only complain once
 
-    // arrows
-    loadChar(face, '*'); // up
-    loadChar(face, ','); // down
-    loadChar(face, '('); // left
-    loadChar(face, ')'); // right
-    loadChar(face, '^'); // dash up
-    loadChar(face, '_'); // dash down
-    loadChar(face, '<'); // dash left
-    loadChar(face, '>'); // dash right
+    if (FT_Init_FreeType(&ft))
+    {
+        LOG_ERROR("Failed to initialize FreeType!");
+        return false;
+    }
 
-    loadChar(face, '#'); // empty box
+    if (!FileSystem::read(BakedFont::FONT_PATH, fontFile)
+        || FT_New_Memory_Face(ft, fontFile.data(), FT_Long(fontFile.size()), 0, &face))
+    {
+        LOG_ERROR("Failed to load %s!", BakedFont::FONT_PATH);
+        face = nullptr;
+        return false;
+    }
 
-    // eyes
-    loadChar(face, '$'); // circle
-    loadChar(face, '%'); // square
-    loadChar(face, '&'); // triangle
+    FT_Set_Pixel_Sizes(face, 0, BakedFont::PIXEL_SIZE);
 
-    Util::glError();
-    LOG_INFO("FreeType init DONE!");
+    faceFailed = false;
+    return true;
 }
 
-void FreeType::loadChar(FT_Face face, char c)
+void FreeType::loadChar(char c)
 {
     // load character glyph 
-    if (FT_Load_Char(face, c, FT_LOAD_RENDER))
+    if (FT_Load_Char(face, (unsigned char)c, FT_LOAD_RENDER))
     {
         LOG_ERROR("FreeType failed to load glyph \'%c\'!", c);
         return;
     }
     
-    // create the texture for this character
-    unsigned int texture;
-    glGenTextures(1, &texture);
-    glBindTexture(GL_TEXTURE_2D, texture);
-    
-    glTexImage2D(
-        GL_TEXTURE_2D,
-        0,
-        GL_ALPHA,
-        face->glyph->bitmap.width,
-        face->glyph->bitmap.rows,
-        0,
-        GL_ALPHA,
-        GL_UNSIGNED_BYTE,
-        face->glyph->bitmap.buffer
-    );
+    const FT_Bitmap& bitmap = face->glyph->bitmap;
+
+    // put it on the glyph atlas, unless there's nothing to draw (space)
+    TextureFrame frame{0, glm::vec4(0)};
+    if (bitmap.width > 0 && bitmap.rows > 0 && !glyphAtlas.add(bitmap.buffer, int(bitmap.width), int(bitmap.rows), frame))
+    {
+        LOG_ERROR("Glyph \'%c\' is too big for the glyph atlas!", c);
+        return;
+    }
 
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    
     FontCharacter character = {
-        texture,
-        glm::ivec2(face->glyph->bitmap.width, face->glyph->bitmap.rows),
+        frame.texId,
+        frame.uvRect,
+        glm::ivec2(bitmap.width, bitmap.rows),
         glm::ivec2(face->glyph->bitmap_left, face->glyph->bitmap_top),
         face->glyph->advance.x
     };
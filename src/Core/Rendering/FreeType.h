@@ -5,13 +5,43 @@
 #include FT_FREETYPE_H
 
 #include "Types.h"
+#include "Core/FileSystem.h"
+#include "Core/Rendering/TextureAtlas.h"
 
+// glyphs come from the baked font (see BakedFont) when there is one. FreeType only gets loaded when
+// there isn't, or for a glyph the baked font doesn't have.
 class FreeType
 {
 public:
-    void loadChar(FT_Face face, char c);
-
     FreeType();
 
+    // nullptr if the font can't draw it
+    const FontCharacter* getCharacter(char c);
+
+private:
+    // uploads the baked font's page in one go, false if there isn't a usable one
+    bool loadBaked();
+
+    // opens the font the first time something has to be rasterised
+    bool openFace();
+    void loadChar(char c);
+
     std::unordered_map<char, FontCharacter> loadedCharacters;
+
+    FT_Library ft = nullptr;
+    FT_Face face = nullptr;
+    bool faceFailed = false;
+
+    FileData fontFile; // FreeType reads the font straight from here, so it has to stay alive
+
+    // live glyphs go on one page too so a whole label is still one draw call.
+    // ES2 has no GL_RED, the glyph shaders read the matching channel
+#ifdef PLATFORM_WEB
+    static constexpr GLenum GLYPH_FORMAT = GL_ALPHA;
+#else
+    static constexpr GLenum GLYPH_FORMAT = GL_RED;
+#endif
+    static constexpr int GLYPH_ATLAS_SIZE = 512;
+
+    TextureAtlas glyphAtlas{GLYPH_ATLAS_SIZE, GLYPH_FORMAT, GL_LINEAR};
 };
@@ -0,0 +1,93 @@
+#include "GLState.h"
+
+#include "Core.h"
+
+namespace GLState
+{
+    static GLuint curProgram = 0;
+    static GLuint curUnit = 0;
+    static GLuint curTextures[TEXTURE_UNITS] = {};
+    static GLuint curVertexArray = 0;
+    static GLuint curFramebuffer = 0;
+
+    static Counters counters;
+    static Counters lastCounters;
+
+    // true if the call has to go to GL, and remembers the new value
+    static bool change(GLuint& current, GLuint value)
+    {
+        if (current == value)
+        {
+            counters.skipped++;
+            return false;
+        }
+
+        current = value;
+        counters.issued++;
+        return true;
+    }
+
+    void useProgram(GLuint program)
+    {
+        if (change(curProgram, program))
+            glUseProgram(program);
+    }
+
+    void bindTexture(GLuint texture, GLuint unit)
+    {
+        if (unit >= TEXTURE_UNITS)
+        {
+            LOG_ERROR("Texture unit %u is out of range!", unit);
+            return;
+        }
+
+        // still switch units when it's bound already, callers that upload right after expect it to be the active one
+        if (change(curUnit, unit))
+            glActiveTexture(GL_TEXTURE0 + unit);
+
+        if (change(curTextures[unit], texture))
+            glBindTexture(GL_TEXTURE_2D, texture);
+    }
+
+    void bindVertexArray(GLuint vertexArray)
+    {
+        if (change(curVertexArray, vertexArray))
+            glBindVertexArray(vertexArray);
+    }
+
+    void bindFramebuffer(GLuint framebuffer)
+    {
+        if (change(curFramebuffer, framebuffer))
+            glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    }
+
+    void deleteTexture(GLuint texture)
+    {
+        for (GLuint& bound : curTextures)
+        {
+            if (bound == texture)
+                bound = 0;
+        }
+
+        glDeleteTextures(1, &texture);
+    }
+
+    void deleteVertexArray(GLuint vertexArray)
+    {
+        if (curVertexArray == vertexArray)
+            curVertexArray = 0;
+
+        glDeleteVertexArrays(1, &vertexArray);
+    }
+
+    void endFrame()
+    {
+        lastCounters = counters;
+        counters = Counters{};
+    }
+
+    const Counters& lastFrame()
+    {
+        return lastCounters;
+    }
+}
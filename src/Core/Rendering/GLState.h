@@ -0,0 +1,29 @@
+#pragma once
+
+#include <glad/glad.h>
+
+// remembers what's bound so binding the same program, texture, VAO or framebuffer again doesn't
+// reach the driver. Everything that binds these has to go through here, or the cache goes stale.
+namespace GLState
+{
+    static constexpr GLuint TEXTURE_UNITS = 8;
+
+    void useProgram(GLuint program);
+    void bindTexture(GLuint texture, GLuint unit = 0);
+    void bindVertexArray(GLuint vertexArray);
+    void bindFramebuffer(GLuint framebuffer);
+
+    // GL unbinds deleted objects by itself, these make the cache agree
+    void deleteTexture(GLuint texture);
+    void deleteVertexArray(GLuint vertexArray);
+
+    struct Counters
+    {
+        int issued = 0;  // calls that got to GL
+        int skipped = 0; // calls that would have set what was already set
+    };
+
+    // starts counting a new frame, lastFrame() is what the one that just ended did
+    void endFrame();
+    const Counters& lastFrame();
+}
@@ -9,6 +9,7 @@
 #include "Constants.h"
 #include "Util.h"
 #include "Framebuffer.h"
+#include "GLState.h"
 
 class OpenGL
 {
@@ -87,7 +88,7 @@ public:
         GLuint quadVBO;
         glGenVertexArrays(1, &crtVAO);
         glGenBuffers(1, &quadVBO);
-        glBindVertexArray(crtVAO);
+        GLState::bindVertexArray(crtVAO);
         glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
         glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), &quadVertices, GL_STATIC_DRAW);
         glEnableVertexAttribArray(0);
@@ -0,0 +1,180 @@
+#include "ProgramCache.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+#include <GLFW/glfw3.h>
+
+#include "Core.h"
+#include "Util.h"
+
+// ARB_get_program_binary isn't in our glad (it's core in 4.1, we ask for 3.3), so it's loaded by hand
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+
+typedef void (APIENTRYP PFNGETPROGRAMBINARY)(GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, void* binary);
+typedef void (APIENTRYP PFNPROGRAMBINARY)(GLuint program, GLenum binaryFormat, const void* binary, GLsizei length);
+typedef void (APIENTRYP PFNPROGRAMPARAMETERI)(GLuint program, GLenum pname, GLint value);
+
+namespace ProgramCache
+{
+    static constexpr char MAGIC[4] = { 'O', 'P', 'R', 'G' };
+    static constexpr uint32_t VERSION = 1;
+
+    struct Header
+    {
+        char magic[4];
+        uint32_t version;
+        Key key;
+        uint32_t format;
+        uint32_t length;
+    };
+
+    static_assert(sizeof(Header) == 28);
+
+    static PFNGETPROGRAMBINARY getProgramBinary = nullptr;
+    static PFNPROGRAMBINARY programBinary = nullptr;
+    static PFNPROGRAMPARAMETERI programParameteri = nullptr;
+
+    static bool supported()
+    {
+#ifdef PLATFORM_WEB
+        return false; // WebGL has no program binaries
+#else
+        static const bool isSupported = []
+        {
+            bool hasExtension = GLVersion.major > 4 || (GLVersion.major == 4 && GLVersion.minor >= 1);
+
+            GLint extensionCount = 0;
+            glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+            for (GLint i = 0; i < extensionCount && !hasExtension; i++)
+            {
+                const auto* extension = (const char*)glGetStringi(GL_EXTENSIONS, i);
+                hasExtension = extension && strcmp(extension, "GL_ARB_get_program_binary") == 0;
+            }
+
+            if (!hasExtension)
+                return false;
+
+            // some drivers have the extension but won't give out any binaries
+            GLint formatCount = 0;
+            glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+            if (formatCount <= 0)
+                return false;
+
+            getProgramBinary = PFNGETPROGRAMBINARY(glfwGetProcAddress("glGetProgramBinary"));
+            programBinary = PFNPROGRAMBINARY(glfwGetProcAddress("glProgramBinary"));
+            programParameteri = PFNPROGRAMPARAMETERI(glfwGetProcAddress("glProgramParameteri"));
+
+            return getProgramBinary && programBinary && programParameteri;
+        }();
+
+        return isSupported;
+#endif
+    }
+
+    static std::string pathFor(const std::string& name)
+    {
+        return std::string(DIRECTORY) + "/" + name + ".bin";
+    }
+
+    Key makeKey(const std::string& vertexCode, const std::string& fragmentCode)
+    {
+        std::string driver;
+        for (GLenum name : { GL_VENDOR, GL_RENDERER, GL_VERSION })
+        {
+            const auto* str = (const char*)glGetString(name);
+            driver += str ? str : "";
+            driver += '\n';
+        }
+
+        return Key{
+            uint32_t(Util::hashBytes(vertexCode.data(), vertexCode.size())),
+            uint32_t(Util::hashBytes(fragmentCode.data(), fragmentCode.size())),
+            uint32_t(Util::hashBytes(driver.data(), driver.size()))
+        };
+    }
+
+    bool load(GLuint program, const std::string& name, const Key& key)
+    {
+        if (!supported())
+            return false;
+
+        std::ifstream file(pathFor(name), std::ios::binary);
+        if (!file)
+            return false;
+
+        Header header{};
+        file.read((char*)&header, sizeof(header));
+
+        if (!file || memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION
+            || header.key.vertexHash != key.vertexHash || header.key.fragmentHash != key.fragmentHash
+            || header.key.driverHash != key.driverHash)
+            return false; // stale, gets replaced after compiling
+
+        // the length is whatever was on disk, a cut off or corrupt file shouldn't get to pick how much we allocate
+        std::error_code ec;
+        const uintmax_t fileSize = std::filesystem::file_size(pathFor(name), ec);
+        if (ec || fileSize != sizeof(header) + uintmax_t(header.length))
+            return false;
+
+        std::vector<char> binary(header.length);
+        file.read(binary.data(), std::streamsize(binary.size()));
+        if (!file)
+            return false;
+
+        programBinary(program, header.format, binary.data(), GLsizei(binary.size()));
+
+        // drivers are allowed to refuse binaries whenever they like, that just means compiling again
+        GLint success = 0;
+        glGetProgramiv(program, GL_LINK_STATUS, &success);
+        if (!success)
+        {
+            LOG_INFO("Cached shader program %s was rejected by the driver, recompiling", name.c_str());
+            return false;
+        }
+
+        return true;
+    }
+
+    void prepare(GLuint program)
+    {
+        if (supported())
+            programParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+
+    void save(GLuint program, const std::string& name, const Key& key)
+    {
+        if (!supported())
+            return;
+
+        GLint length = 0;
+        glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+        if (length <= 0)
+            return;
+
+        std::vector<char> binary(length);
+        GLenum format = 0;
+        getProgramBinary(program, length, &length, &format, binary.data());
+
+        Header header{};
+        memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = VERSION;
+        header.key = key;
+        header.format = format;
+        header.length = uint32_t(length);
+
+        std::error_code ec;
+        std::filesystem::create_directories(DIRECTORY, ec);
+
+        std::ofstream file(pathFor(name), std::ios::binary);
+        file.write((const char*)&header, sizeof(header));
+        file.write(binary.data(), length);
+
+        if (!file)
+            LOG_ERROR("Couldn't write %s, shaders will be compiled again next time", pathFor(name).c_str());
+    }
+}
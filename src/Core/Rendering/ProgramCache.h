@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include <glad/glad.h>
+
+// keeps linked shader programs on disk (glGetProgramBinary), so later launches skip compiling and linking.
+// A cached program is only used if it was built from the same sources by the same driver, anything else
+// just compiles from source again and replaces it. Does nothing on web or on drivers without program binaries.
+namespace ProgramCache
+{
+    static constexpr const char* DIRECTORY = "shadercache";
+
+    struct Key
+    {
+        uint32_t vertexHash;
+        uint32_t fragmentHash;
+        uint32_t driverHash; // vendor, renderer and version, binaries don't survive driver updates
+    };
+
+    Key makeKey(const std::string& vertexCode, const std::string& fragmentCode);
+
+    // links program from the cached binary, false if there isn't a matching one or the driver refused it
+    bool load(GLuint program, const std::string& name, const Key& key);
+
+    // call before linking, drivers may not keep the binary around otherwise
+    void prepare(GLuint program);
+
+    // call after a successful link
+    void save(GLuint program, const std::string& name, const Key& key);
+}
@@ -1,11 +1,15 @@
 #include "Shader.h"
 #include "Core.h"
 
+#include <algorithm>
 #include <fstream>
 
 #include <glm/ext/matrix_clip_space.hpp>
 
 #include "Util.h"
+#include "Core/Rendering/GLState.h"
+#include "Core/Rendering/ProgramCache.h"
+#include "Core/Rendering/UniformBuffer.h"
 
 Shader::Shader(const GLchar* vertexName, const GLchar* fragmentName)
 {
@@ -24,6 +28,31 @@ Shader::Shader(const GLchar* vertexName, const GLchar* fragmentName)
     std::string vertexCode = Util::readAllBytes("res/" + vertexPath);
     std::string fragmentCode = Util::readAllBytes("res/" + fragmentPath);
 
+    ID = glCreateProgram();
+
+    // a program linked from these exact sources by this driver before can be loaded as is
+    const std::string cacheName = vName + "-" + fName;
+    const ProgramCache::Key cacheKey = ProgramCache::makeKey(vertexCode, fragmentCode);
+
+    if (!ProgramCache::load(ID, cacheName, cacheKey) && compileAndLink(vertexCode, fragmentCode, vertexPath, fragmentPath))
+        ProgramCache::save(ID, cacheName, cacheKey);
+
+    findUniforms();
+
+#ifndef PLATFORM_WEB
+    // point the shared uniform blocks this shader declares at their buffers, see UniformBuffer
+    for (GLuint block = 0; block < GLuint(UniformBlock::COUNT); block++)
+    {
+        const GLuint index = glGetUniformBlockIndex(ID, UNIFORM_BLOCK_NAMES[block]);
+        if (index != GL_INVALID_INDEX)
+            glUniformBlockBinding(ID, index, block);
+    }
+#endif
+}
+
+bool Shader::compileAndLink(const std::string& vertexCode, const std::string& fragmentCode,
+                            const std::string& vertexPath, const std::string& fragmentPath)
+{
     const char* vCode = vertexCode.c_str();
     const char* fCode = fragmentCode.c_str();
 
@@ -55,10 +84,15 @@ Shader::Shader(const GLchar* vertexName, const GLchar* fragmentName)
     }
 
     // shader program
-    ID = glCreateProgram();
     glAttachShader(ID, vertex);
     glAttachShader(ID, fragment);
 
+    // ES shaders can't use layout qualifiers, so pin the sprite batch's attributes here. Names a shader doesn't have are ignored
+    glBindAttribLocation(ID, 0, "pos");
+    glBindAttribLocation(ID, 1, "uv");
+    glBindAttribLocation(ID, 2, "color");
+
+    ProgramCache::prepare(ID);
     glLinkProgram(ID);
     // print linking errors if any
     glGetProgramiv(ID, GL_LINK_STATUS, &success);
@@ -71,105 +105,135 @@ Shader::Shader(const GLchar* vertexName, const GLchar* fragmentName)
     // delete the shaders as they're linked into our program now and no longer necessary
     glDeleteShader(vertex);
     glDeleteShader(fragment);
+
+    return success;
 }
 
 // use/activate the shader
 void Shader::use() const
 {
-    glUseProgram(ID);
+    GLState::useProgram(ID);
 }
 
 // utility uniform functions
-void Shader::setBool(const char* name, const bool value) const
+void Shader::setBool(const Uniform uniform, const bool value) const
 {
-    glUniform1i(getUniformLocation(name), int(value));
+    glUniform1i(getUniformLocation(uniform), int(value));
 }
 
 // ------------------------------------------------------------------------
-void Shader::setInt(const char* name, const int value) const
+void Shader::setInt(const Uniform uniform, const int value) const
 {
-    glUniform1i(getUniformLocation(name), value);
+    glUniform1i(getUniformLocation(uniform), value);
 }
 
 // ------------------------------------------------------------------------
-void Shader::setFloat(const char* name, const float value) const
+void Shader::setFloat(const Uniform uniform, const float value) const
 {
-    glUniform1f(getUniformLocation(name), value);
+    glUniform1f(getUniformLocation(uniform), value);
 }
 
 // ------------------------------------------------------------------------
-void Shader::setVec2(const char* name, const glm::vec2& value) const
+void Shader::setVec2(const Uniform uniform, const glm::vec2& value) const
 {
-    glUniform2fv(getUniformLocation(name), 1, &value[0]);
+    glUniform2fv(getUniformLocation(uniform), 1, &value[0]);
 }
 
-void Shader::setVec2(const char* name, const float x, const float y) const
+void Shader::setVec2(const Uniform uniform, const float x, const float y) const
 {
-    glUniform2f(getUniformLocation(name), x, y);
+    glUniform2f(getUniformLocation(uniform), x, y);
 }
 
 // ------------------------------------------------------------------------
-void Shader::setVec3(const char* name, const glm::vec3& value) const
+void Shader::setVec3(const Uniform uniform, const glm::vec3& value) const
 {
-    glUniform3fv(getUniformLocation(name), 1, &value[0]);
+    glUniform3fv(getUniformLocation(uniform), 1, &value[0]);
 }
 
-void Shader::setVec3(const char* name, const float x, const float y, const float z) const
+void Shader::setVec3(const Uniform uniform, const float x, const float y, const float z) const
 {
-    glUniform3f(getUniformLocation(name), x, y, z);
+    glUniform3f(getUniformLocation(uniform), x, y, z);
 }
 
 // ------------------------------------------------------------------------
-void Shader::setVec4(const char* name, const glm::vec4& value) const
+void Shader::setVec4(const Uniform uniform, const glm::vec4& value) const
 {
-    glUniform4fv(getUniformLocation(name), 1, &value[0]);
+    glUniform4fv(getUniformLocation(uniform), 1, &value[0]);
 }
 
-void Shader::setVec4(const char* name, const float x, const float y, const float z, const float w) const
+void Shader::setVec4(const Uniform uniform, const float x, const float y, const float z, const float w) const
 {
-    glUniform4f(getUniformLocation(name), x, y, z, w);
+    glUniform4f(getUniformLocation(uniform), x, y, z, w);
 }
 
 // ------------------------------------------------------------------------
-void Shader::setMat2(const char* name, const glm::mat2& mat) const
+void Shader::setMat2(const Uniform uniform, const glm::mat2& mat) const
 {
-    glUniformMatrix2fv(getUniformLocation(name), 1, GL_FALSE, &mat[0][0]);
+    glUniformMatrix2fv(getUniformLocation(uniform), 1, GL_FALSE, &mat[0][0]);
 }
 
 // ------------------------------------------------------------------------
-void Shader::setMat3(const char* name, const glm::mat3& mat) const
+void Shader::setMat3(const Uniform uniform, const glm::mat3& mat) const
 {
-    glUniformMatrix3fv(getUniformLocation(name), 1, GL_FALSE, &mat[0][0]);
+    glUniformMatrix3fv(getUniformLocation(uniform), 1, GL_FALSE, &mat[0][0]);
 }
 
 // ------------------------------------------------------------------------
-void Shader::setMat4(const char* name, const glm::mat4& mat) const
+void Shader::setMat4(const Uniform uniform, const glm::mat4& mat) const
 {
-    glUniformMatrix4fv(getUniformLocation(name), 1, GL_FALSE, &mat[0][0]);
+    glUniformMatrix4fv(getUniformLocation(uniform), 1, GL_FALSE, &mat[0][0]);
 }
 
-GLint Shader::getUniformLocation(const char* uniformName) const
+void Shader::findUniforms()
 {
-    std::size_t hash = Util::hashBytes(uniformName, strlen(uniformName));
+    uniformLocations.fill(-1);
 
-    const auto f = uniformCache.find(hash);
+    GLint count = 0;
+    GLint maxLength = 0;
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
 
-    GLint loc;
+    std::string name(std::max(maxLength, 1), '\0');
 
-    if (f == uniformCache.end())
+    // hashed the same way Uniform does it, so a uniform's slot is where its compile time index points
+    auto add = [&](const std::string& uniformName)
     {
-        // get uniform location
-        loc = glGetUniformLocation(ID, uniformName);
+        const GLint location = glGetUniformLocation(ID, uniformName.c_str());
+        if (location == -1)
+            return; // uniform block members are listed too, those are set through their buffer
 
-        std::pair<std::size_t, GLuint> newLoc(hash, loc);
-        uniformCache.insert(newLoc);
-    }
-    else
+        const std::size_t index = uniformIndex(uniformHash(uniformName));
+        if (index == UNIFORM_COUNT)
+        {
+            LOG_INFO("Shader uniform %s isn't in UNIFORM_NAMES, it can't be set", uniformName.c_str());
+            return;
+        }
+
+        uniformLocations[index] = location;
+    };
+
+    for (GLint i = 0; i < count; i++)
     {
-        loc = (*f).second;
-    }
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(ID, GLuint(i), GLsizei(name.size()), &length, &size, &type, name.data());
 
-    return loc;
+        const std::string uniformName(name.data(), length);
+
+        // arrays show up once as "name[0]", every element has its own location though
+        const std::size_t bracket = uniformName.rfind("[0]");
+        if (size > 1 && bracket != std::string::npos && bracket + 3 == uniformName.size())
+        {
+            const std::string base = uniformName.substr(0, bracket);
+            for (GLint element = 0; element < size; element++)
+                add(base + "[" + std::to_string(element) + "]");
+        }
+        else
+        {
+            add(uniformName);
+        }
+    }
 }
 
 // utility function for checking shader compilation/linking errors
@@ -1,11 +1,13 @@
 #pragma once
 
-#include <unordered_map>
+#include <array>
 #include <string>
 
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 
+#include "Core/Rendering/Uniform.h"
+
 class Camera;
 
 class Shader
@@ -22,33 +24,41 @@ public:
     // activate the shader
     void use() const;
 
-    // utility uniform functions
-    void setBool(const char* name, bool value) const;
+    // utility uniform functions, names are checked and looked up while compiling, see Uniform
+    void setBool(Uniform uniform, bool value) const;
     // ------------------------------------------------------------------------
-    void setInt(const char* name, int value) const;
+    void setInt(Uniform uniform, int value) const;
     // ------------------------------------------------------------------------
-    void setFloat(const char* name, float value) const;
+    void setFloat(Uniform uniform, float value) const;
     // ------------------------------------------------------------------------
-    void setVec2(const char* name, const glm::vec2& value) const;
-    void setVec2(const char* name, float x, float y) const;
+    void setVec2(Uniform uniform, const glm::vec2& value) const;
+    void setVec2(Uniform uniform, float x, float y) const;
     // ------------------------------------------------------------------------
-    void setVec3(const char* name, const glm::vec3& value) const;
-    void setVec3(const char* name, float x, float y, float z) const;
+    void setVec3(Uniform uniform, const glm::vec3& value) const;
+    void setVec3(Uniform uniform, float x, float y, float z) const;
     // ------------------------------------------------------------------------
-    void setVec4(const char* name, const glm::vec4& value) const;
-    void setVec4(const char* name, float x, float y, float z, float w) const;
+    void setVec4(Uniform uniform, const glm::vec4& value) const;
+    void setVec4(Uniform uniform, float x, float y, float z, float w) const;
     // ------------------------------------------------------------------------
-    void setMat2(const char* name, const glm::mat2& mat) const;
+    void setMat2(Uniform uniform, const glm::mat2& mat) const;
     // ------------------------------------------------------------------------
-    void setMat3(const char* name, const glm::mat3& mat) const;
+    void setMat3(Uniform uniform, const glm::mat3& mat) const;
     // ------------------------------------------------------------------------
-    void setMat4(const char* name, const glm::mat4& mat) const;
+    void setMat4(Uniform uniform, const glm::mat4& mat) const;
 
 private:
+    // builds the program from source, false if it didn't compile or link
+    bool compileAndLink(const std::string& vertexCode, const std::string& fragmentCode,
+                        const std::string& vertexPath, const std::string& fragmentPath);
+
     // utility function for checking shader compilation/linking errors.
     static void checkCompileErrors(GLuint shader, const std::string& type);
 
-    GLint getUniformLocation(const char* uniformName) const;
+    // fills uniformLocations from the program's active uniforms, has to run after every link
+    void findUniforms();
+
+    GLint getUniformLocation(const Uniform uniform) const { return uniformLocations[uniform.index]; }
 
-    mutable std::unordered_map<size_t, GLint> uniformCache;
+    // indexed like UNIFORM_NAMES, -1 for uniforms this program doesn't have (GL ignores sets to -1)
+    std::array<GLint, UNIFORM_COUNT> uniformLocations;
 };
@@ -1,13 +1,27 @@
 #include "SimpleTexture.h"
 
+#include "GLState.h"
+
 SimpleTexture::SimpleTexture(const GLuint& _texId)
 {
     texId = _texId;
 }
 
+SimpleTexture::SimpleTexture(const TextureFrame& frame)
+{
+    texId = frame.texId;
+    uvRect = frame.uvRect;
+}
+
 void SimpleTexture::bind() const
 {
-    glBindTexture(GL_TEXTURE_2D, texId);
+    GLState::bindTexture(texId);
+}
+
+void SimpleTexture::setFrames(const std::vector<TextureFrame>& frames)
+{
+    texId = frames.at(0).texId;
+    uvRect = frames.at(0).uvRect;
 }
 
 void SimpleTexture::tick()
@@ -20,5 +34,5 @@ void SimpleTexture::reset()
 
 bool SimpleTexture::operator==(const SimpleTexture& st) const
 {
-    return texId == st.texId;
+    return texId == st.texId && uvRect == st.uvRect; // sprites on the same atlas page share a texId
 }
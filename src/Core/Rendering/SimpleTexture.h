@@ -1,8 +1,17 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include <glad/glad.h>
+#include <glm/vec4.hpp>
+
+// where one image lives: a whole texture of its own, or a rectangle on an atlas page
+struct TextureFrame
+{
+    GLuint texId = 0;
+    glm::vec4 uvRect = glm::vec4(0, 0, 1, 1); // xy = top left, zw = size, in UVs
+};
 
 class SimpleTexture
 {
@@ -10,15 +19,20 @@ public:
     SimpleTexture() = default;
 
     SimpleTexture(const GLuint& _texId);
+    SimpleTexture(const TextureFrame& frame);
 
     void bind() const;
 
+    // called by TextureManager when the images behind this handle are on the GPU
+    virtual void setFrames(const std::vector<TextureFrame>& frames);
+
     virtual void tick();
 
     virtual void reset();
     bool shouldTick = false;
 
     GLuint texId = 0;
+    glm::vec4 uvRect = glm::vec4(0, 0, 1, 1); // goes to the sprite batch, see TextureFrame
 
     bool operator==(const SimpleTexture& st) const;
 
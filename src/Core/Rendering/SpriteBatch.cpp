@@ -0,0 +1,104 @@
+#include "SpriteBatch.h"
+
+#include <cstddef>
+
+#include <glm/common.hpp>
+
+#include "Shader.h"
+#include "GLState.h"
+
+SpriteBatch::SpriteBatch()
+{
+    vertices.reserve(MAX_QUADS * 4);
+
+    // indices never change, every quad is two triangles of its 4 verts
+    std::vector<GLushort> indices(MAX_QUADS * 6);
+    for (int i = 0; i < MAX_QUADS; i++)
+    {
+        const GLushort v = GLushort(i * 4);
+
+        indices[i * 6 + 0] = v + 0;
+        indices[i * 6 + 1] = v + 1;
+        indices[i * 6 + 2] = v + 2;
+        indices[i * 6 + 3] = v + 2;
+        indices[i * 6 + 4] = v + 3;
+        indices[i * 6 + 5] = v + 0;
+    }
+
+    glGenVertexArrays(1, &vao);
+    glGenBuffers(1, &vbo);
+    glGenBuffers(1, &ebo);
+
+    GLState::bindVertexArray(vao);
+
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData(GL_ARRAY_BUFFER, MAX_QUADS * 4 * sizeof(Vertex), nullptr, GL_STREAM_DRAW);
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLushort), indices.data(), GL_STATIC_DRAW);
+
+    // locations match the glBindAttribLocation calls in Shader
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*) offsetof(Vertex, x));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*) offsetof(Vertex, u));
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Vertex), (void*) offsetof(Vertex, r));
+
+    GLState::bindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+SpriteBatch::~SpriteBatch()
+{
+    glDeleteBuffers(1, &ebo);
+    glDeleteBuffers(1, &vbo);
+    GLState::deleteVertexArray(vao);
+}
+
+void SpriteBatch::draw(const Shader& shader, GLuint texId, const glm::vec2& pos, const glm::vec2& size,
+                       const glm::vec4& uvRect, const glm::vec3& color)
+{
+    if (&shader != curShader || texId != curTexture || vertices.size() == MAX_QUADS * 4)
+    {
+        flush();
+
+        curShader = &shader;
+        curTexture = texId;
+    }
+
+    const glm::vec2 end = pos + size;
+    const glm::vec2 uvEnd = glm::vec2(uvRect.x + uvRect.z, uvRect.y + uvRect.w);
+
+    const glm::vec3 c = glm::clamp(color, 0.0f, 1.0f) * 255.0f + 0.5f;
+    const uint8_t r = uint8_t(c.r), g = uint8_t(c.g), b = uint8_t(c.b);
+
+    vertices.push_back({pos.x, pos.y, uvRect.x, uvRect.y, r, g, b, 255});
+    vertices.push_back({pos.x, end.y, uvRect.x, uvEnd.y, r, g, b, 255});
+    vertices.push_back({end.x, end.y, uvEnd.x, uvEnd.y, r, g, b, 255});
+    vertices.push_back({end.x, pos.y, uvEnd.x, uvRect.y, r, g, b, 255});
+}
+
+void SpriteBatch::flush()
+{
+    if (vertices.empty())
+        return;
+
+    curShader->use();
+
+    GLState::bindTexture(curTexture);
+    GLState::bindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+
+    // orphan the old storage so we don't wait on the GPU still drawing the last batch
+    glBufferData(GL_ARRAY_BUFFER, MAX_QUADS * 4 * sizeof(Vertex), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, vertices.size() * sizeof(Vertex), vertices.data());
+
+    const int quadCount = int(vertices.size() / 4);
+    glDrawElements(GL_TRIANGLES, quadCount * 6, GL_UNSIGNED_SHORT, nullptr);
+
+    // the VAO stays bound, nothing else touches element buffers so there's no need to pay for unbinding it
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    vertices.clear();
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <glad/glad.h>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+#include "Core.h"
+
+class Shader;
+
+// collects sprites into one streaming vertex buffer and draws them together, instead of one draw call per sprite.
+// Quads are drawn in the order they're queued, so a flush happens whenever the shader or texture changes.
+// With sprites packed into atlases (see TextureAtlas) most of a frame ends up as a handful of draw calls.
+class SpriteBatch
+{
+public:
+    // 4 verts per quad, indices have to fit in a GLushort for ES2
+    static constexpr int MAX_QUADS = 4096;
+
+    SpriteBatch();
+    ~SpriteBatch();
+
+    DISALLOW_COPY_AND_ASSIGN(SpriteBatch)
+
+    // queues a quad. pos/size are in framebuffer pixels, uvRect is xy = top left, zw = size like TextureFrame.
+    // color goes to the shader as a vertex color, only the glyph shader uses it for now.
+    void draw(const Shader& shader, GLuint texId, const glm::vec2& pos, const glm::vec2& size,
+              const glm::vec4& uvRect = glm::vec4(0, 0, 1, 1), const glm::vec3& color = glm::vec3(1.0f));
+
+    // draws everything queued. Call before anything else touches GL state the batch depends on,
+    // like binding a framebuffer, changing uniforms or drawing without the batch.
+    void flush();
+
+private:
+    struct Vertex
+    {
+        float x, y;
+        float u, v;
+        uint8_t r, g, b, a;
+    };
+
+    std::vector<Vertex> vertices;
+
+    const Shader* curShader = nullptr;
+    GLuint curTexture = 0;
+
+    GLuint vao = 0;
+    GLuint vbo = 0;
+    GLuint ebo = 0;
+};
@@ -0,0 +1,84 @@
+#include "TextureAtlas.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "GLState.h"
+
+TextureAtlas::TextureAtlas(int _pageSize, GLenum _format, GLint _filter)
+    : pageSize(_pageSize), format(_format), filter(_filter)
+{ }
+
+void TextureAtlas::addPage()
+{
+    Page& page = pages.emplace_back();
+
+    glGenTextures(1, &page.texId);
+    GLState::bindTexture(page.texId);
+    glTexImage2D(GL_TEXTURE_2D, 0, format, pageSize, pageSize, 0, format, GL_UNSIGNED_BYTE, nullptr);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+}
+
+bool TextureAtlas::add(const unsigned char* data, int width, int height, TextureFrame& out)
+{
+    if (width > maxImageSize() || height > maxImageSize())
+        return false;
+
+    const int paddedWidth = width + 2 * PADDING;
+    const int paddedHeight = height + 2 * PADDING;
+
+    if (pages.empty())
+        addPage();
+
+    Page* page = &pages.back();
+
+    // start a new shelf, or a new page if that doesn't fit either
+    if (page->shelfX + paddedWidth > pageSize)
+    {
+        page->shelfY += page->shelfHeight;
+        page->shelfX = 0;
+        page->shelfHeight = 0;
+    }
+
+    if (page->shelfY + paddedHeight > pageSize)
+    {
+        addPage();
+        page = &pages.back();
+    }
+
+    const int x = page->shelfX;
+    const int y = page->shelfY;
+
+    page->shelfX += paddedWidth;
+    page->shelfHeight = std::max(page->shelfHeight, paddedHeight);
+
+    // copy into a padded image, repeating the edges into the padding
+    const int channels = format == GL_RGBA ? 4 : format == GL_RGB ? 3 : 1;
+    std::vector<unsigned char> padded(std::size_t(paddedWidth) * paddedHeight * channels);
+
+    for (int py = 0; py < paddedHeight; py++)
+    {
+        const int srcY = std::clamp(py - PADDING, 0, height - 1);
+
+        for (int px = 0; px < paddedWidth; px++)
+        {
+            const int srcX = std::clamp(px - PADDING, 0, width - 1);
+
+            memcpy(&padded[(std::size_t(py) * paddedWidth + px) * channels],
+                   &data[(std::size_t(srcY) * width + srcX) * channels], channels);
+        }
+    }
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1); // RGB and one channel rows aren't 4-byte aligned
+    GLState::bindTexture(page->texId);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, paddedWidth, paddedHeight, format, GL_UNSIGNED_BYTE, padded.data());
+
+    out.texId = page->texId;
+    out.uvRect = glm::vec4(float(x + PADDING), float(y + PADDING), float(width), float(height)) / float(pageSize);
+
+    return true;
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <vector>
+
+#include <glad/glad.h>
+
+#include "Core.h"
+#include "SimpleTexture.h"
+
+// packs lots of images into a few big textures, so a whole animation is one texture instead of one per frame.
+// Pages get filled shelf by shelf: images go left to right in rows as tall as the tallest image in them.
+class TextureAtlas
+{
+public:
+    // every image gets its edge pixels repeated around it, so filtering never picks up its neighbours
+    static constexpr int PADDING = 1;
+
+    // format is GL_RGB, GL_RGBA or a one channel format like GL_RED, filter is the mag filter like TextureManager::createTexture
+    TextureAtlas(int _pageSize, GLenum _format, GLint _filter);
+
+    DISALLOW_COPY_AND_ASSIGN(TextureAtlas)
+
+    // images bigger than this are better off as their own texture, they'd leave too much of a page empty
+    int maxImageSize() const { return pageSize / 4 - 2 * PADDING; }
+
+    // copies the image into a page. Returns false if it's too big for the atlas.
+    bool add(const unsigned char* data, int width, int height, TextureFrame& out);
+
+    std::size_t pageCount() const { return pages.size(); }
+
+private:
+    struct Page
+    {
+        GLuint texId;
+
+        int shelfX = 0;      // where the next image goes on the current shelf
+        int shelfY = 0;      // top of the current shelf
+        int shelfHeight = 0; // tallest image on the current shelf so far
+    };
+
+    void addPage();
+
+    std::vector<Page> pages;
+
+    const int pageSize;
+    const GLenum format;
+    const GLint filter;
+};
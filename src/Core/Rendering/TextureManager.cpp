@@ -6,8 +6,14 @@
 #endif
 
 #include "stbimg.h"
+#include <algorithm>
+#include <chrono>
 #include <string>
 
+#include "Outrospection.h"
+#include "Core/FileSystem.h"
+#include "Core/Rendering/GLState.h"
+#include "Core/Rendering/TextureAtlas.h"
 #include "Core/Rendering/TickableTexture.h"
 
 SimpleTexture TextureManager::MissingTexture(-1);
@@ -41,28 +47,38 @@ TextureManager::TextureManager()
     createTexture(texId, noneTexData, GL_RGBA, 2, 2, GL_NEAREST);
 
     None.texId = texId;
+
+    GLint maxTextureSize = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTextureSize);
+    atlasPageSize = std::min(int(maxTextureSize), MAX_ATLAS_PAGE_SIZE);
 }
 
-SimpleTexture& TextureManager::loadTexture(const Resource& r, const GLint& filter)
+TextureManager::~TextureManager()
 {
-    const std::string path = r.getResourcePath() + ".png";
+#ifndef PLATFORM_WEB
+    // the workers outlive us, but whatever they're decoding for us still has to land somewhere
+    Outrospection::get().workers.wait();
 
-    const GLuint texId = textureFromFile(path, filter);
+    for (DecodedImage& image : decoded)
+        stbi_image_free(image.data);
+#endif
 
-    if (texId != INT_MAX)
-    {
-        SimpleTexture texObj(texId);
+    for (DecodedImage& image : ready)
+        stbi_image_free(image.data);
+}
 
-        textures.insert(std::pair(r, std::make_unique<SimpleTexture>(texObj)));
+SimpleTexture& TextureManager::loadTexture(const Resource& r, const GLint& filter)
+{
+    const TextureId id = textures.add(r.getResourcePath());
+    std::unique_ptr<SimpleTexture>& texture = textures[id];
+    if (texture)
+        return *texture;
 
-        return *textures[r];
-    }
-    else
-    {
-        LOG_ERROR("Failed to generate texture ID for %s", path.c_str());
+    texture = std::make_unique<SimpleTexture>(None.texId);
 
-        return MissingTexture;
-    }
+    queueFrame(texture.get(), 0, r.getResourcePath() + ".png", filter);
+
+    return *texture;
 }
 
 SimpleTexture& TextureManager::loadAnimatedTexture(const Resource& r, unsigned int textureTickLength,
@@ -70,29 +86,20 @@ SimpleTexture& TextureManager::loadAnimatedTexture(const Resource& r, unsigned i
 {
     std::string path = r.getResourcePath();
 
-    std::vector<GLuint> textureIds;
+    const TextureId id = textures.add(path);
+    std::unique_ptr<SimpleTexture>& texture = textures[id];
+    if (texture)
+        return *texture;
 
-    for (unsigned int i = 0; i < textureFrameCount; i++)
-    {
-        GLuint currentTextureId = textureFromFile(path + std::to_string(i) + ".png", filter);
+    // every frame shows None until they've all loaded
+    std::vector<TextureFrame> frames(textureFrameCount, TextureFrame{ None.texId });
 
-        if (currentTextureId != INT_MAX)
-        {
-            textureIds.push_back(currentTextureId);
-        }
-        else
-        {
-            LOG_ERROR("Failed to generate texture ID for animated texture frame %i at %s", textureFrameCount,
-                      (path + std::to_string(i) + ".png").c_str());
+    texture = std::make_unique<TickableTexture>(frames, path, textureTickLength);
 
-            textureIds.push_back(MissingTexture.texId);
-        }
-    }
-
-    auto [it, success] = textures.insert(
-        std::pair(r, std::make_unique<TickableTexture>(textureIds, path, textureTickLength)));
+    for (unsigned int i = 0; i < textureFrameCount; i++)
+        queueFrame(texture.get(), i, path + std::to_string(i) + ".png", filter);
 
-    return *(it->second);
+    return *texture;
 }
 
 void TextureManager::bindTexture(Resource& r)
@@ -104,9 +111,9 @@ void TextureManager::bindTexture(Resource& r)
 
 SimpleTexture& TextureManager::get(const Resource& r)
 {
-    const auto f = textures.find(r);
+    const TextureId id = find(r);
 
-    if (f == textures.end())
+    if (!id.valid())
     {
         // resource not found in already existing storage, needs to be loaded
         LOG_ERROR("Texture %s was not loaded before fetching! Loading now as fallback...", r.getResourcePath().c_str());
@@ -114,23 +121,88 @@ SimpleTexture& TextureManager::get(const Resource& r)
     }
     else
     {
-        return *(*f).second;
+        return get(id);
     }
 }
 
+SimpleTexture& TextureManager::get(TextureId id)
+{
+    return *textures[id];
+}
+
+TextureId TextureManager::find(const Resource& r) const
+{
+    return textures.find(r.getResourcePath());
+}
+
 // Called every tick, calls tick on every tickable texture.
 void TextureManager::tickAllTextures()
 {
-    for (auto& val : textures)
+    for (auto& texture : textures)
     {
-        val.second->tick();
+        texture->tick();
+    }
+}
+
+void TextureManager::uploadPending()
+{
+#ifndef PLATFORM_WEB
+    {
+        std::lock_guard lock(decodedMutex);
+        for (DecodedImage& image : decoded)
+            ready.push_back(std::move(image));
+
+        decoded.clear();
+    }
+#endif
+
+    const auto start = std::chrono::steady_clock::now();
+    const auto budget = std::chrono::microseconds(UPLOAD_BUDGET_MICROS);
+
+    // always at least one, so loading moves along even when frames are slow
+    bool first = true;
+    while (first || std::chrono::steady_clock::now() - start < budget)
+    {
+        first = false;
+
+#ifdef PLATFORM_WEB
+        if (ready.empty() && !toDecode.empty())
+        {
+            decode(toDecode.front());
+            ready.push_back(std::move(toDecode.front()));
+            toDecode.pop_front();
+        }
+#endif
+
+        if (ready.empty())
+            return;
+
+        DecodedImage image = std::move(ready.front());
+        ready.pop_front();
+
+        PendingTexture& texture = pending.at(image.texture);
+
+        if (!uploadFrame(image, texture.frames[image.frame]))
+            texture.frames[image.frame] = TextureFrame{ MissingTexture.texId };
+
+        stbi_image_free(image.data);
+
+        if (--texture.remaining == 0)
+        {
+            image.texture->setFrames(texture.frames);
+            pending.erase(image.texture);
+        }
     }
 }
 
 unsigned char* TextureManager::readImageBytes(const std::string& path, int& width, int& height)
 {
+    FileData file;
+    if (!FileSystem::read(path, file))
+        return nullptr;
+
     int nrComponents = 0;
-    return stbi_load(path.c_str(), &width, &height, &nrComponents, 0);
+    return stbi_load_from_memory(file.data(), int(file.size()), &width, &height, &nrComponents, 0);
 }
 
 void TextureManager::free(unsigned char* data)
@@ -141,7 +213,7 @@ void TextureManager::free(unsigned char* data)
 void TextureManager::createTexture(const GLuint& texId, const unsigned char* data, const GLenum& format,
                                    const unsigned int& width, const unsigned int& height, const GLint& filter)
 {
-    glBindTexture(GL_TEXTURE_2D, texId);
+    GLState::bindTexture(texId);
     glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
     
     // TODO make this an option
@@ -153,37 +225,79 @@ void TextureManager::createTexture(const GLuint& texId, const unsigned char* dat
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
 }
 
-GLuint TextureManager::textureFromFile(const std::string& filename, const GLint& filter)
+void TextureManager::queueFrame(SimpleTexture* texture, unsigned int frame, std::string path, GLint filter)
 {
-    GLuint tex;
-    int width, height;
-    glGenTextures(1, &tex);
+    PendingTexture& loading = pending[texture];
+    if (frame >= loading.frames.size())
+        loading.frames.resize(frame + 1);
+    loading.remaining++;
 
-    int nrComponents = 0;
-    unsigned char* data = stbi_load(filename.c_str(), &width, &height, &nrComponents, 0);
+    DecodedImage image{ texture, frame, std::move(path), filter };
 
-    if (data)
+#ifdef PLATFORM_WEB
+    toDecode.push_back(std::move(image));
+#else
+    Outrospection::get().workers.submit([this, image = std::move(image)]() mutable
     {
-        GLenum format;
-        if (nrComponents == 1)
-            format = GL_RED;
-        else if (nrComponents == 3)
-            format = GL_RGB;
-        else if (nrComponents == 4)
-            format = GL_RGBA;
+        decode(image);
 
-        createTexture(tex, data, format, width, height, filter);
+        std::lock_guard lock(decodedMutex);
+        decoded.push_back(std::move(image));
+    });
+#endif
+}
 
-        stbi_image_free(data);
+void TextureManager::decode(DecodedImage& image)
+{
+    FileData file;
+    if (FileSystem::read(image.path, file))
+    {
+        image.data = stbi_load_from_memory(file.data(), int(file.size()), &image.width, &image.height,
+                                           &image.channels, 0);
+    }
 
-        return tex;
+    if (!image.data)
+        image.failure = stbi_failure_reason();
+}
+
+bool TextureManager::uploadFrame(const DecodedImage& image, TextureFrame& out)
+{
+    if (!image.data)
+    {
+        LOG_ERROR("Texture failed to load at path: %s", image.path.c_str());
+        LOG_ERROR("stbi_failure_reason: %s", image.failure ? image.failure : "file not found");
+
+        return false;
     }
+
+    GLenum format;
+    if (image.channels == 1)
+        format = GL_RED;
+    else if (image.channels == 3)
+        format = GL_RGB;
+    else if (image.channels == 4)
+        format = GL_RGBA;
     else
     {
-        LOG_ERROR("Texture failed to load at path: %s", filename.c_str());
-        LOG_ERROR("stbi_failure_reason: %s", stbi_failure_reason());
-        stbi_image_free(data);
+        LOG_ERROR("Texture %s has %i channels, only 1, 3 and 4 work", image.path.c_str(), image.channels);
+
+        return false;
+    }
+
+    // small enough images share atlas pages, big ones get their own texture
+    if (format != GL_RED)
+    {
+        std::unique_ptr<TextureAtlas>& atlas = atlases[std::pair(format, image.filter)];
+        if (!atlas)
+            atlas = std::make_unique<TextureAtlas>(atlasPageSize, format, image.filter);
 
-        return INT_MAX;
+        if (atlas->add(image.data, image.width, image.height, out))
+            return true;
     }
+
+    out = TextureFrame{};
+    glGenTextures(1, &out.texId);
+    createTexture(out.texId, image.data, format, image.width, image.height, image.filter);
+
+    return true;
 }
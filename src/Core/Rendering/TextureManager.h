@@ -1,22 +1,75 @@
 #pragma once
 #include "Core.h"
 
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <unordered_map>
+#include <vector>
 //#include <unordered_set>
 
 #include <glad/glad.h>
 
 #include "Resource.h"
 #include "Types.h"
+#include "Core/Registry.h"
 
 #include "SimpleTexture.h"
+#include "TextureAtlas.h"
+
+// a loaded texture, from TextureManager::find
+typedef Handle<struct TextureTag> TextureId;
 
 class TextureManager
 {
 private:
-    std::unordered_map<Resource, std::unique_ptr<SimpleTexture>, Hashes> textures;
+    // keyed by full path, the path is only hashed when a texture is loaded or found by name
+    InternedRegistry<std::unique_ptr<SimpleTexture>, TextureTag> textures;
+
+    // one atlas per format and filter, since a page can only have one of each
+    std::map<std::pair<GLenum, GLint>, std::unique_ptr<TextureAtlas>> atlases;
+    int atlasPageSize = 0;
+
+    static constexpr int MAX_ATLAS_PAGE_SIZE = 4096;
+
+    // how long uploadPending() may spend on the GL thread each frame
+    static constexpr int UPLOAD_BUDGET_MICROS = 4000;
+
+    // one image file that's been asked for, and what came out of decoding it
+    struct DecodedImage
+    {
+        SimpleTexture* texture; // the handle it's a frame of, only ever touched on the GL thread
+        unsigned int frame;
+        std::string path;
+        GLint filter;
+
+        unsigned char* data = nullptr; // from stbi, nullptr if decoding failed
+        int width = 0;
+        int height = 0;
+        int channels = 0;
+        const char* failure = nullptr; // stbi_failure_reason() is per thread, so it's kept here
+    };
+
+    // frames of a handle that's still loading, it gets them all at once when the last one is up
+    struct PendingTexture
+    {
+        std::vector<TextureFrame> frames;
+        unsigned int remaining;
+    };
+
+    std::unordered_map<SimpleTexture*, PendingTexture> pending;
+    std::deque<DecodedImage> ready; // decoded and waiting for the GL thread
+
+#ifdef PLATFORM_WEB
+    std::deque<DecodedImage> toDecode; // no threads on web, these get decoded inside the upload budget instead
+#else
+    std::mutex decodedMutex;
+    std::vector<DecodedImage> decoded; // filled by Outrospection's workers, moved into ready every frame
+#endif
 public:
     TextureManager();
+    ~TextureManager();
 
     SimpleTexture& loadTexture(const Resource& r, const GLint& filter = GL_LINEAR);
 
@@ -26,9 +79,17 @@ public:
     void bindTexture(Resource& r);
 
     SimpleTexture& get(const Resource& r);
+    SimpleTexture& get(TextureId id);
+
+    // an invalid id if it was never loaded
+    TextureId find(const Resource& r) const;
 
     void tickAllTextures();
 
+    // loading hands out handles right away that show None, the images are decoded on worker threads.
+    // This puts the decoded ones on the GPU until UPLOAD_BUDGET_MICROS runs out, call it once a frame
+    void uploadPending();
+
     static SimpleTexture MissingTexture;
     static SimpleTexture None;
 
@@ -37,7 +98,14 @@ public:
 
     DISALLOW_COPY_AND_ASSIGN(TextureManager);
 private:
-    static GLuint textureFromFile(const std::string& filename, const GLint& filter);
+    // asks for one frame of a handle, it's filled in by uploadPending() once it's decoded
+    void queueFrame(SimpleTexture* texture, unsigned int frame, std::string path, GLint filter);
+
+    // runs on a worker, reads and decodes image.path into the rest of image
+    static void decode(DecodedImage& image);
+
+    // puts a decoded image into an atlas page, or its own texture if it's too big for one
+    bool uploadFrame(const DecodedImage& image, TextureFrame& out);
     static void createTexture(const GLuint& texId, const unsigned char* data, const GLenum& format,
                               const unsigned int& width, const unsigned int& height, const GLint& filter);
 };
@@ -1,12 +1,19 @@
 #include "TickableTexture.h"
 
-TickableTexture::TickableTexture(const std::vector<GLuint>& texIds, const std::string& _texPath,
+TickableTexture::TickableTexture(const std::vector<TextureFrame>& _frames, const std::string& _texPath,
                                  const unsigned int _frameLength)
-    : SimpleTexture(texIds.at(0)), textures(texIds), frameLength(_frameLength)
+    : SimpleTexture(_frames.at(0)), frames(_frames), frameLength(_frameLength)
 {
     shouldTick = true;
+}
+
+void TickableTexture::setFrames(const std::vector<TextureFrame>& _frames)
+{
+    frames = _frames;
 
-    texId = textures[0];
+    // keep playing from wherever the animation got to while it was loading
+    texId = frames.at(curFrame).texId;
+    uvRect = frames.at(curFrame).uvRect;
 }
 
 void TickableTexture::tick()
@@ -33,16 +40,18 @@ void TickableTexture::tick(unsigned int& stepCount)
 
 void TickableTexture::nextFrame()
 {
-    if (curFrame < (textures.size() - 1))
+    if (curFrame < (frames.size() - 1))
         curFrame++;
     else
         curFrame = 0;
 
-    texId = textures.at(curFrame);
+    texId = frames.at(curFrame).texId;
+    uvRect = frames.at(curFrame).uvRect;
 }
 
 void TickableTexture::reset()
 {
     curFrame = 0;
-    texId = textures.at(curFrame);
+    texId = frames.at(curFrame).texId;
+    uvRect = frames.at(curFrame).uvRect;
 }
@@ -8,7 +8,9 @@
 class TickableTexture : public SimpleTexture
 {
 public:
-    TickableTexture(const std::vector<GLuint>& texIds, const std::string& _texPath, unsigned int _frameLength);
+    TickableTexture(const std::vector<TextureFrame>& _frames, const std::string& _texPath, unsigned int _frameLength);
+
+    void setFrames(const std::vector<TextureFrame>& _frames) override;
 
     void tick() override;
 
@@ -18,7 +20,7 @@ public:
 
     void reset() override;
 private:
-    const std::vector<GLuint> textures;
+    std::vector<TextureFrame> frames;
     const unsigned int frameLength;
 
     unsigned int frameTally = 0;
@@ -0,0 +1,70 @@
+#include "Tilemap.h"
+
+#include "Outrospection.h"
+#include "GLState.h"
+#include "Shader.h"
+#include "SimpleTexture.h"
+
+Tilemap::~Tilemap()
+{
+    GLState::deleteTexture(gridTex);
+}
+
+void Tilemap::setGrid(int width, int height, const std::vector<uint8_t>& cells)
+{
+    // RGBA rather than an integer texture so ES2 can read it too, a layer is on where its channel is 255
+    std::vector<uint8_t> texels(std::size_t(width) * height * 4, 0);
+    for (std::size_t i = 0; i < cells.size() && i < texels.size() / 4; i++)
+    {
+        for (int layer = 0; layer < LAYER_COUNT; layer++)
+        {
+            if (cells[i] & (1 << layer))
+                texels[i * 4 + layer] = 255;
+        }
+    }
+
+    if (gridTex == 0)
+        glGenTextures(1, &gridTex);
+
+    GLState::bindTexture(gridTex);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, texels.data());
+
+    // one texel per cell, nothing should ever blend between them
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+    gridSize = glm::vec2(width, height);
+}
+
+void Tilemap::draw(const Shader& shader, const glm::vec2& pos, const glm::vec2& size,
+                   const std::array<const SimpleTexture*, LAYER_COUNT>& layers) const
+{
+    if (gridTex == 0)
+        return;
+
+    SpriteBatch& batch = Outrospection::get().spriteBatch;
+
+    // the uniforms and texture units below would change under anything still queued
+    batch.flush();
+
+    shader.use();
+    shader.setInt("tiles", 0);
+    shader.setVec2("gridSize", gridSize);
+
+    static constexpr Uniform LAYER_UNIFORMS[LAYER_COUNT] = { "layers[0]", "layers[1]", "layers[2]" };
+    static constexpr Uniform RECT_UNIFORMS[LAYER_COUNT] = { "layerRects[0]", "layerRects[1]", "layerRects[2]" };
+
+    for (int i = 0; i < LAYER_COUNT; i++)
+    {
+        // unit 0 is the grid, the batch binds that one
+        GLState::bindTexture(layers[i]->texId, i + 1);
+
+        shader.setInt(LAYER_UNIFORMS[i], i + 1);
+        shader.setVec4(RECT_UNIFORMS[i], layers[i]->uvRect);
+    }
+
+    batch.draw(shader, gridTex, pos, size);
+    batch.flush();
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include <glad/glad.h>
+#include <glm/vec2.hpp>
+
+#include "Core.h"
+
+class Shader;
+class SimpleTexture;
+
+// draws a whole grid of tiles in one pass. The grid is uploaded once as a tiny texture with one texel per cell,
+// and the tilemap shader looks up which layers each cell has, so the cost doesn't depend on the grid size.
+class Tilemap
+{
+public:
+    // layers are stacked in order, each one is a texture channel of the grid
+    static constexpr int LAYER_COUNT = 3;
+
+    Tilemap() = default;
+    ~Tilemap();
+
+    DISALLOW_COPY_AND_ASSIGN(Tilemap)
+
+    // cells are row by row, bit i of a cell means layer i is drawn there
+    void setGrid(int width, int height, const std::vector<uint8_t>& cells);
+
+    // draws the grid stretched over pos/size (in framebuffer pixels) with the layers' current frames
+    void draw(const Shader& shader, const glm::vec2& pos, const glm::vec2& size,
+              const std::array<const SimpleTexture*, LAYER_COUNT>& layers) const;
+
+private:
+    GLuint gridTex = 0;
+    glm::vec2 gridSize{};
+};
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <string_view>
+
+#include "Util.h"
+
+// every plain uniform any shader has. Shader looks all of these up once after linking, so setting one
+// is just an index into its table. Array elements each get their own entry, a new uniform goes here first
+constexpr const char* UNIFORM_NAMES[] = {
+    "projection",
+    "viewportHeight",
+    "time",
+    "image",
+    "glyph",
+    "screenTexture",
+    "tiles",
+    "gridSize",
+    "layers[0]",
+    "layers[1]",
+    "layers[2]",
+    "layerRects[0]",
+    "layerRects[1]",
+    "layerRects[2]"
+};
+
+constexpr std::size_t UNIFORM_COUNT = std::size(UNIFORM_NAMES);
+
+constexpr std::size_t uniformHash(std::string_view name)
+{
+    return Util::hashBytes(name.data(), name.size());
+}
+
+// index of the uniform with this hash, UNIFORM_COUNT if there isn't one
+constexpr std::size_t uniformIndex(std::size_t hash)
+{
+    for (std::size_t i = 0; i < UNIFORM_COUNT; i++)
+    {
+        if (uniformHash(UNIFORM_NAMES[i]) == hash)
+            return i;
+    }
+
+    return UNIFORM_COUNT;
+}
+
+constexpr bool uniformHashesUnique()
+{
+    for (std::size_t i = 0; i < UNIFORM_COUNT; i++)
+    {
+        if (uniformIndex(uniformHash(UNIFORM_NAMES[i])) != i)
+            return false;
+    }
+
+    return true;
+}
+
+static_assert(uniformHashesUnique(), "two uniform names hash the same, rename one");
+
+// never defined, calling it from a consteval function is what makes the build fail
+void uniformIsNotInUniformNames();
+
+// a uniform name that's hashed and found in UNIFORM_NAMES while compiling, so shader.setInt("tiles", 0)
+// doesn't touch the string at runtime. Names that aren't in the list don't compile
+class Uniform
+{
+public:
+    consteval Uniform(const char* name)
+        : hash(uniformHash(name)), index(uniformIndex(hash))
+    {
+        if (index == UNIFORM_COUNT)
+            uniformIsNotInUniformNames();
+    }
+
+    std::size_t hash;
+    std::size_t index;
+};
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <iterator>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "Core.h"
+
+// uniform blocks shaders can declare, each one always lives at the binding point of the same number.
+// Shader hooks blocks up by name after linking, so a shader only has to declare the block to get the data
+enum class UniformBlock : GLuint
+{
+    VIEWPORT,
+
+    COUNT
+};
+
+constexpr const char* UNIFORM_BLOCK_NAMES[] = { "Viewport" };
+static_assert(std::size(UNIFORM_BLOCK_NAMES) == std::size_t(UniformBlock::COUNT));
+
+// std140 layout of the Viewport block, updated whenever a framebuffer is bound
+struct ViewportUniforms
+{
+    glm::mat4 projection;
+    glm::vec2 viewportSize;
+    float time; // seconds since the game started
+    float padding;
+};
+
+static_assert(sizeof(ViewportUniforms) == 80);
+
+// backs a uniform block with one buffer, so state every shader needs is one buffer write
+// instead of a use() and a set on each shader. ES2 doesn't have these, the web build sets plain uniforms.
+template<typename T>
+class UniformBuffer
+{
+public:
+    explicit UniformBuffer(UniformBlock block)
+    {
+        glGenBuffers(1, &ubo);
+        glBindBuffer(GL_UNIFORM_BUFFER, ubo);
+        glBufferData(GL_UNIFORM_BUFFER, sizeof(T), nullptr, GL_DYNAMIC_DRAW);
+        glBindBufferBase(GL_UNIFORM_BUFFER, GLuint(block), ubo);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    }
+
+    ~UniformBuffer()
+    {
+        glDeleteBuffers(1, &ubo);
+    }
+
+    DISALLOW_COPY_AND_ASSIGN(UniformBuffer)
+
+    void update(const T& data)
+    {
+        glBindBuffer(GL_UNIFORM_BUFFER, ubo);
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(T), &data);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    }
+
+private:
+    GLuint ubo = 0;
+};
@@ -0,0 +1,65 @@
+#include "Scheduler.h"
+
+#include <algorithm>
+#include <functional>
+
+TimerId Scheduler::schedule(SmallTask task, std::chrono::milliseconds delay)
+{
+    uint32_t slot;
+    if (freeSlots.empty())
+    {
+        slot = uint32_t(slots.size());
+        slots.emplace_back();
+    }
+    else
+    {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+    }
+
+    slots[slot].task = std::move(task);
+
+    const uint32_t generation = slots[slot].generation;
+    heap.push_back(Timer{ Clock::now() + delay, nextOrder++, slot, generation });
+    std::push_heap(heap.begin(), heap.end(), std::greater<>());
+
+    return TimerId{ slot, generation };
+}
+
+bool Scheduler::cancel(TimerId id)
+{
+    if (id.slot >= slots.size() || slots[id.slot].generation != id.generation)
+        return false;
+
+    release(id.slot);
+    return true;
+}
+
+void Scheduler::run(Clock::time_point now)
+{
+    const uint64_t scheduledBefore = nextOrder;
+
+    while (!heap.empty() && heap.front().due <= now && heap.front().order < scheduledBefore)
+    {
+        std::pop_heap(heap.begin(), heap.end(), std::greater<>());
+        const Timer timer = heap.back();
+        heap.pop_back();
+
+        if (slots[timer.slot].generation != timer.generation)
+            continue; // cancelled
+
+        // out of its slot before it runs, it might schedule something that gets the same slot
+        SmallTask task = release(timer.slot);
+        task();
+    }
+}
+
+SmallTask Scheduler::release(uint32_t slot)
+{
+    SmallTask task = std::move(slots[slot].task);
+
+    slots[slot].generation++;
+    freeSlots.push_back(slot);
+
+    return task;
+}
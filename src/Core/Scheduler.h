@@ -0,0 +1,59 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include "Core/SmallTask.h"
+
+// one callback waiting in a Scheduler, stays safe to cancel after it's run or been cancelled
+struct TimerId
+{
+    uint32_t slot = UINT32_MAX;
+    uint32_t generation = 0;
+};
+
+// callbacks that run on the main thread some time from now, see Util::doLater. They're kept in a min heap
+// on steady_clock, so finding the ones that are due is a look at the top, and changing the clock doesn't move them
+class Scheduler
+{
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    TimerId schedule(SmallTask task, std::chrono::milliseconds delay);
+
+    // false if it already ran or was cancelled
+    bool cancel(TimerId id);
+
+    // runs everything that's due, in the order it's due. Tasks can schedule and cancel from in here,
+    // anything they schedule waits for the next run even with no delay
+    void run(Clock::time_point now = Clock::now());
+
+private:
+    struct Timer
+    {
+        Clock::time_point due;
+        uint64_t order; // scheduled first runs first when they're due at the same time
+        uint32_t slot;
+        uint32_t generation;
+
+        bool operator>(const Timer& t) const
+        {
+            return due != t.due ? due > t.due : order > t.order;
+        }
+    };
+
+    struct Slot
+    {
+        SmallTask task;
+        uint32_t generation = 0; // bumped whenever the slot frees up, so old ids stop matching
+    };
+
+    // frees the slot and hands back its task
+    SmallTask release(uint32_t slot);
+
+    std::vector<Timer> heap; // cancelled timers stay in here until they come up and get skipped
+    std::vector<Slot> slots;
+    std::vector<uint32_t> freeSlots;
+    uint64_t nextOrder = 0;
+};
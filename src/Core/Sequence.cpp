@@ -0,0 +1,147 @@
+#include "Sequence.h"
+
+#include <exception>
+#include <new>
+
+#include "Outrospection.h"
+
+// frames up to FRAME_SIZE are kept for the next sequence instead of freed, the ones in this game are a few hundred bytes
+static constexpr std::size_t FRAME_SIZE = 512;
+
+struct FramePool
+{
+    std::vector<void*> frames;
+
+    ~FramePool()
+    {
+        for (void* frame : frames)
+            ::operator delete(frame);
+    }
+};
+
+static std::vector<void*>& freeFrames()
+{
+    static FramePool pool;
+    return pool.frames;
+}
+
+void* Sequence::promise_type::operator new(std::size_t size)
+{
+    if (size > FRAME_SIZE)
+        return ::operator new(size);
+
+    std::vector<void*>& frames = freeFrames();
+    if (frames.empty())
+        return ::operator new(FRAME_SIZE);
+
+    void* frame = frames.back();
+    frames.pop_back();
+    return frame;
+}
+
+void Sequence::promise_type::operator delete(void* frame, std::size_t size)
+{
+    if (size > FRAME_SIZE)
+        ::operator delete(frame);
+    else
+        freeFrames().push_back(frame);
+}
+
+Sequence Sequence::promise_type::get_return_object()
+{
+    return Sequence(Coroutine::from_promise(*this));
+}
+
+void Sequence::promise_type::unhandled_exception()
+{
+    std::terminate();
+}
+
+void Sequence::Delay::await_suspend(Coroutine coroutine) const
+{
+    promise_type& promise = coroutine.promise();
+    promise.running = false;
+
+    if (promise.cancelled)
+    {
+        coroutine.destroy(); // this awaiter is gone too now, nothing past here can touch it
+        return;
+    }
+
+    promise.timer = Outrospection::get().scheduler.schedule([coroutine]
+    {
+        coroutine.promise().running = true;
+        coroutine.resume();
+    }, std::chrono::milliseconds(millis));
+}
+
+Sequence::Delay Sequence::delay(time_t millis)
+{
+    return Delay{ millis };
+}
+
+Sequence::Delay Sequence::nextTick()
+{
+    return Delay{ 0 };
+}
+
+Sequence::~Sequence()
+{
+    reset();
+}
+
+Sequence::Sequence(Sequence&& other) noexcept : coroutine(other.coroutine)
+{
+    other.coroutine = nullptr;
+}
+
+Sequence& Sequence::operator=(Sequence&& other) noexcept
+{
+    if (this != &other)
+    {
+        reset();
+        coroutine = other.coroutine;
+        other.coroutine = nullptr;
+    }
+
+    return *this;
+}
+
+void Sequence::reset()
+{
+    if (!coroutine)
+        return;
+
+    promise_type& promise = coroutine.promise();
+    if (promise.running)
+    {
+        // it's what called this, it can't be destroyed until it's off the stack
+        promise.detached = true;
+        promise.cancelled = true;
+    }
+    else
+    {
+        Outrospection::get().scheduler.cancel(promise.timer);
+        coroutine.destroy();
+    }
+
+    coroutine = nullptr;
+}
+
+void Sequence::detach()
+{
+    if (!coroutine)
+        return;
+
+    if (coroutine.done())
+        coroutine.destroy();
+    else
+        coroutine.promise().detached = true;
+
+    coroutine = nullptr;
+}
+
+bool Sequence::done() const
+{
+    return !coroutine || coroutine.done();
+}
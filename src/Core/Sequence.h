@@ -0,0 +1,97 @@
+#pragma once
+
+#include <coroutine>
+#include <cstddef>
+#include <ctime>
+#include <vector>
+
+#include "Core/Scheduler.h"
+
+// a coroutine that runs on Outrospection's scheduler, for things that happen over time and read better in order:
+//
+//     Sequence GUIScene::dying()
+//     {
+//         co_await Sequence::delay(1500);
+//         reset();
+//     }
+//
+// It starts right away and runs until its first co_await. Resetting or destroying the Sequence cancels it,
+// even from inside itself, in which case it stops at its next co_await. Frames come from a pool, so once
+// a sequence has run before, running it again doesn't allocate. Main thread only
+class Sequence
+{
+public:
+    struct promise_type
+    {
+        TimerId timer; // what it's waiting on
+        bool running = true;
+        bool detached = false; // nothing owns it, it frees itself when it's done
+        bool cancelled = false; // reset while it was running, it stops at its next co_await
+
+        Sequence get_return_object();
+
+        std::suspend_never initial_suspend() noexcept { return {}; }
+
+        // owned sequences stay around finished until their owner lets go
+        struct FinalAwaiter
+        {
+            bool await_ready() noexcept { return detached; }
+            void await_suspend(std::coroutine_handle<>) noexcept {}
+            void await_resume() noexcept {}
+
+            bool detached;
+        };
+
+        FinalAwaiter final_suspend() noexcept
+        {
+            running = false;
+            return FinalAwaiter{ detached };
+        }
+
+        void return_void() {}
+        void unhandled_exception();
+
+        static void* operator new(std::size_t size);
+        static void operator delete(void* frame, std::size_t size);
+    };
+
+    typedef std::coroutine_handle<promise_type> Coroutine;
+
+    struct Delay
+    {
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(Coroutine coroutine) const;
+        void await_resume() const noexcept {}
+
+        time_t millis;
+    };
+
+    // picks up again after millis, on the first scheduler run after that
+    static Delay delay(time_t millis);
+
+    // picks up again on the next scheduler run, so the next frame
+    static Delay nextTick();
+
+    Sequence() = default;
+    ~Sequence();
+
+    Sequence(Sequence&& other) noexcept;
+    Sequence& operator=(Sequence&& other) noexcept;
+
+    Sequence(const Sequence&) = delete;
+    Sequence& operator=(const Sequence&) = delete;
+
+    // cancels it if it hasn't finished
+    void reset();
+
+    // lets it run to the end on its own, for sequences nothing needs to cancel
+    void detach();
+
+    // not started, cancelled or ran to the end
+    bool done() const;
+
+private:
+    explicit Sequence(Coroutine _coroutine) : coroutine(_coroutine) {}
+
+    Coroutine coroutine;
+};
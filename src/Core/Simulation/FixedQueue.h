@@ -0,0 +1,59 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+// ring buffer with a compile-time capacity, never allocates
+template <typename T, std::size_t N>
+class FixedQueue
+{
+public:
+    // returns false (and drops the value) if the queue is full
+    bool push_back(const T& value)
+    {
+        if (count == N)
+            return false;
+
+        items[(head + count) % N] = value;
+        count++;
+
+        return true;
+    }
+
+    void pop_front()
+    {
+        head = (head + 1) % N;
+        count--;
+    }
+
+    void pop_back()
+    {
+        count--;
+    }
+
+    T& front() { return items[head]; }
+    const T& front() const { return items[head]; }
+
+    T& back() { return items[(head + count - 1) % N]; }
+    const T& back() const { return items[(head + count - 1) % N]; }
+
+    T& operator[](std::size_t i) { return items[(head + i) % N]; }
+    const T& operator[](std::size_t i) const { return items[(head + i) % N]; }
+
+    std::size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    bool full() const { return count == N; }
+
+    void clear()
+    {
+        head = 0;
+        count = 0;
+    }
+
+    static constexpr std::size_t capacity() { return N; }
+
+private:
+    std::array<T, N> items{};
+    std::size_t head = 0;
+    std::size_t count = 0;
+};
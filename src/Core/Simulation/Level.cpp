@@ -0,0 +1,98 @@
+#include "Level.h"
+
+#include <algorithm>
+
+static constexpr std::string_view VALID_TILES = "WH SG";
+static constexpr std::string_view VALID_CONTROLS = "*,()^_<>";
+
+bool parseLevel(std::string_view text, Level& level, std::string& error)
+{
+    nlohmann::json j = nlohmann::json::parse(text, nullptr, false);
+
+    if (j.is_discarded())
+    {
+        error = "not valid json";
+        return false;
+    }
+
+    if (!j.is_object() || !j.contains("level") || !j["level"].is_array() || j["level"].empty())
+    {
+        error = "\"level\" must be a list of rows";
+        return false;
+    }
+
+    if (!j.contains("controls") || !j["controls"].is_string())
+    {
+        error = "\"controls\" must be a string";
+        return false;
+    }
+
+    for (const char* field : { "guideLeft", "guideRight", "author" })
+    {
+        if (j.contains(field) && !j[field].is_string())
+        {
+            error = "\"" + std::string(field) + "\" must be a string";
+            return false;
+        }
+    }
+
+    std::size_t rowLength = 0;
+    int starts = 0, goals = 0;
+
+    for (std::size_t y = 0; y < j["level"].size(); y++)
+    {
+        const nlohmann::json& row = j["level"][y];
+
+        if (!row.is_string())
+        {
+            error = "row " + std::to_string(y) + " is not a string";
+            return false;
+        }
+
+        const std::string& tiles = row.get_ref<const std::string&>();
+
+        if (y == 0)
+            rowLength = tiles.size();
+
+        if (tiles.empty() || tiles.size() != rowLength)
+        {
+            error = "row " + std::to_string(y) + " is " + std::to_string(tiles.size()) + " tiles long, expected " + std::to_string(rowLength);
+            return false;
+        }
+
+        for (std::size_t x = 0; x < tiles.size(); x++)
+        {
+            if (VALID_TILES.find(tiles[x]) == std::string_view::npos)
+            {
+                error = "unknown tile '" + std::string(1, tiles[x]) + "' at " + std::to_string(x) + "," + std::to_string(y);
+                return false;
+            }
+
+            starts += tiles[x] == 'S';
+            goals += tiles[x] == 'G';
+        }
+    }
+
+    if (starts != 1 || goals != 1)
+    {
+        error = "needs exactly one S and one G, found " + std::to_string(starts) + " and " + std::to_string(goals);
+        return false;
+    }
+
+    const std::string& controls = j["controls"].get_ref<const std::string&>();
+
+    auto badControl = std::find_if(controls.begin(), controls.end(), [](char c)
+    {
+        return VALID_CONTROLS.find(c) == std::string_view::npos;
+    });
+
+    if (badControl != controls.end())
+    {
+        error = "unknown control '" + std::string(1, *badControl) + "'";
+        return false;
+    }
+
+    level = j.get<Level>();
+
+    return true;
+}
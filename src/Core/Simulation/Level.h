@@ -0,0 +1,120 @@
+#pragma once
+
+#include <numeric>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <json.hpp>
+
+// integer position on the level grid
+struct GridPos
+{
+    int x = 0;
+    int y = 0;
+
+    constexpr GridPos operator+(const GridPos& other) const
+    {
+        return GridPos{ x + other.x, y + other.y };
+    }
+
+    constexpr GridPos& operator+=(const GridPos& other)
+    {
+        x += other.x;
+        y += other.y;
+        return *this;
+    }
+
+    constexpr bool operator==(const GridPos& other) const = default;
+};
+
+struct Level
+{
+    std::string data;
+    int rowLength;
+    std::string controls;
+
+    GridPos start;
+    GridPos goal;
+
+    std::string guideRight;
+    std::string guideLeft;
+
+    std::string author;
+};
+
+// a level that doesn't own its data: a parsed Level, or one read straight out of a mapped bundle
+struct LevelView
+{
+    std::string_view data;
+    int rowLength = 0;
+    std::string_view controls;
+
+    GridPos start;
+    GridPos goal;
+
+    std::string_view guideRight;
+    std::string_view guideLeft;
+
+    std::string_view author;
+
+    LevelView() = default;
+
+    LevelView(const Level& level)
+        : data(level.data), rowLength(level.rowLength), controls(level.controls), start(level.start), goal(level.goal),
+          guideRight(level.guideRight), guideLeft(level.guideLeft), author(level.author)
+    { }
+};
+
+// assumes the json was already checked by parseLevel, a level without S or G starts/ends at 0,0
+inline void from_json(const nlohmann::json& j, Level& lvl)
+{
+    auto rows = j["level"].get<std::vector<std::string>>();
+    lvl.rowLength = rows[0].size();
+    lvl.data = std::accumulate(begin(rows), end(rows), std::string());
+
+    j["controls"].get_to(lvl.controls);
+
+    lvl.guideLeft = j.value("guideLeft", "default");
+    lvl.guideRight = j.value("guideRight", "default");
+
+    auto findTile = [&](char tile)
+    {
+        std::size_t index = lvl.data.find(tile);
+
+        if (index == std::string::npos)
+            return GridPos{};
+
+        lvl.data[index] = ' ';
+        return GridPos{ int(index % lvl.rowLength), int(index / lvl.rowLength) };
+    };
+
+    lvl.start = findTile('S');
+    lvl.goal = findTile('G');
+
+    lvl.author = j.value("author", "Anonymous");
+}
+
+// parses and validates a level file's contents. Returns false and explains why in error if the level is broken.
+bool parseLevel(std::string_view text, Level& level, std::string& error);
+
+enum class Control
+{
+    NONE = ' ',
+    MOVE_UP = '*',
+    MOVE_DOWN = ',',
+    MOVE_LEFT = '(',
+    MOVE_RIGHT = ')',
+    DASH_UP = '^',
+    DASH_DOWN = '_',
+    DASH_LEFT = '<',
+    DASH_RIGHT = '>'
+};
+
+enum class Eye
+{
+    NONE = ' ',
+    CIRCLE = '$',
+    SQUARE = '%',
+    TRIANGLE = '&'
+};
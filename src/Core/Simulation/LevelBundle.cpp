@@ -0,0 +1,202 @@
+#include "LevelBundle.h"
+
+#include <cstring>
+#include <fstream>
+
+#include "Core/Simulation/Replay.h"
+#include "Core/Simulation/Simulation.h"
+
+bool LevelBundle::open(const std::string& path, std::string& error)
+{
+    close();
+
+    if (!FileSystem::read(path, file))
+    {
+        error = "can't open " + path;
+        return false;
+    }
+
+    const uint8_t* bytes = file.data();
+    const std::size_t size = file.size();
+
+    auto fail = [&](const std::string& why)
+    {
+        error = path + ": " + why;
+        file.clear();
+        return false;
+    };
+
+    if (size < sizeof(BundleHeader))
+        return fail("too small to be a level bundle");
+
+    const auto* head = (const BundleHeader*)bytes;
+
+    if (memcmp(head->magic, MAGIC, sizeof(MAGIC)) != 0)
+        return fail("not a level bundle");
+
+    if (head->version != VERSION)
+        return fail("unsupported bundle version " + std::to_string(head->version));
+
+    if (head->fileSize != size)
+        return fail("file is " + std::to_string(size) + " bytes, expected " + std::to_string(head->fileSize));
+
+    if (head->levelCount > (size - sizeof(BundleHeader)) / sizeof(BundleLevel))
+        return fail("level table doesn't fit in the file");
+
+    const auto* table = (const BundleLevel*)(bytes + sizeof(BundleHeader));
+
+    auto inside = [&](uint64_t offset, uint64_t length)
+    {
+        return offset <= size && length <= size - offset;
+    };
+
+    // check everything once here, so looking levels up later is just pointer math
+    for (uint32_t i = 0; i < head->levelCount; i++)
+    {
+        const BundleLevel& lvl = table[i];
+
+        if (lvl.width == 0 || lvl.height == 0 || !inside(lvl.tilesOffset, uint64_t(lvl.width) * lvl.height))
+            return fail("level " + std::to_string(i) + " has a bad tile grid");
+
+        if (lvl.startX >= lvl.width || lvl.startY >= lvl.height || lvl.goalX >= lvl.width || lvl.goalY >= lvl.height)
+            return fail("level " + std::to_string(i) + " starts or ends outside of itself");
+
+        if (lvl.controlCount > sizeof(lvl.controls))
+            return fail("level " + std::to_string(i) + " has too many controls");
+
+        for (const BundleString& str : { lvl.name, lvl.guideLeft, lvl.guideRight, lvl.author })
+        {
+            if (!inside(str.offset, str.length))
+                return fail("level " + std::to_string(i) + " has a bad string");
+        }
+    }
+
+    header = head;
+    levels = table;
+
+    return true;
+}
+
+void LevelBundle::close()
+{
+    header = nullptr;
+    levels = nullptr;
+
+    file.clear();
+}
+
+std::string_view LevelBundle::string(const BundleString& str) const
+{
+    return std::string_view((const char*)file.data() + str.offset, str.length);
+}
+
+LevelView LevelBundle::level(std::size_t index) const
+{
+    const BundleLevel& lvl = levels[index];
+
+    LevelView view;
+    view.data = std::string_view((const char*)file.data() + lvl.tilesOffset, std::size_t(lvl.width) * lvl.height);
+    view.rowLength = lvl.width;
+    view.controls = std::string_view(lvl.controls, lvl.controlCount);
+    view.start = GridPos{ lvl.startX, lvl.startY };
+    view.goal = GridPos{ lvl.goalX, lvl.goalY };
+    view.guideLeft = string(lvl.guideLeft);
+    view.guideRight = string(lvl.guideRight);
+    view.author = string(lvl.author);
+
+    return view;
+}
+
+std::string_view LevelBundle::name(std::size_t index) const
+{
+    return string(levels[index].name);
+}
+
+bool LevelBundle::write(const std::string& path, const std::vector<Source>& sources, std::string& error)
+{
+    std::vector<uint8_t> out(sizeof(BundleHeader) + sources.size() * sizeof(BundleLevel));
+
+    auto append = [&](std::string_view data)
+    {
+        BundleString str{ uint32_t(out.size()), uint32_t(data.size()) };
+
+        out.insert(out.end(), data.begin(), data.end());
+        out.resize((out.size() + 3) & ~std::size_t(3));
+
+        return str;
+    };
+
+    std::vector<BundleLevel> table;
+
+    for (const Source& source : sources)
+    {
+        const Level& level = source.level;
+
+        if (level.rowLength <= 0 || level.rowLength > UINT16_MAX || level.data.size() / level.rowLength > UINT16_MAX)
+        {
+            error = source.name + " is too big for a bundle";
+            return false;
+        }
+
+        if (level.controls.size() > sizeof(BundleLevel::controls))
+        {
+            error = source.name + " has more than 8 controls";
+            return false;
+        }
+
+        BundleLevel lvl{};
+        lvl.tilesOffset = append(level.data).offset;
+        lvl.width = uint16_t(level.rowLength);
+        lvl.height = uint16_t(level.data.size() / level.rowLength);
+        lvl.startX = uint16_t(level.start.x);
+        lvl.startY = uint16_t(level.start.y);
+        lvl.goalX = uint16_t(level.goal.x);
+        lvl.goalY = uint16_t(level.goal.y);
+
+        for (char c : level.controls)
+        {
+            int index = controlIndex(Control(c));
+
+            if (index >= 0)
+                lvl.controlMask |= 1 << index;
+
+            lvl.controls[lvl.controlCount++] = c;
+        }
+
+        lvl.sourceHash = Replay::hashLevel(source.contents);
+
+        lvl.name = append(source.name);
+        lvl.guideLeft = append(level.guideLeft);
+        lvl.guideRight = append(level.guideRight);
+        lvl.author = append(level.author);
+
+        table.push_back(lvl);
+    }
+
+    if (out.size() > UINT32_MAX)
+    {
+        error = "bundle would be bigger than 4GB";
+        return false;
+    }
+
+    BundleHeader head{};
+    memcpy(head.magic, MAGIC, sizeof(MAGIC));
+    head.version = VERSION;
+    head.levelCount = uint32_t(sources.size());
+    head.fileSize = uint32_t(out.size());
+
+    memcpy(out.data(), &head, sizeof(head));
+    if (!table.empty())
+        memcpy(out.data() + sizeof(head), table.data(), table.size() * sizeof(BundleLevel));
+
+    std::ofstream file(path, std::ios::binary);
+    file.write((const char*)out.data(), std::streamsize(out.size()));
+
+    if (!file)
+    {
+        error = "can't write " + path;
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Core/FileSystem.h"
+#include "Core/Simulation/Level.h"
+
+// a level bundle (.olb) is every level of a directory compiled into one file that gets mapped and
+// read in place, no parsing and no copies. Layout, little endian and 4-byte aligned:
+//   BundleHeader
+//   BundleLevel[levelCount]
+//   tile grids and strings, found by offset from the start of the file
+// Tile grids are one char per tile, with S and G already turned into floor, so a Board can point right at them.
+
+struct BundleString
+{
+    uint32_t offset;
+    uint32_t length;
+};
+
+struct BundleHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t levelCount;
+    uint32_t fileSize;
+};
+
+struct BundleLevel
+{
+    uint32_t tilesOffset;
+    uint16_t width;
+    uint16_t height;
+
+    uint16_t startX, startY;
+    uint16_t goalX, goalY;
+
+    uint8_t controlMask;  // bit mask over ALL_CONTROLS
+    uint8_t controlCount;
+    char controls[8];     // in the order the level lists them, that's the order of the buttons
+    uint16_t padding;
+
+    uint32_t sourceHash;  // Replay::hashLevel of the json it was built from, replays check it
+
+    BundleString name;
+    BundleString guideLeft;
+    BundleString guideRight;
+    BundleString author;
+};
+
+static_assert(sizeof(BundleHeader) == 16);
+static_assert(sizeof(BundleLevel) == 64);
+
+class LevelBundle
+{
+public:
+    static constexpr char MAGIC[4] = { 'O', 'L', 'V', 'B' };
+    static constexpr uint32_t VERSION = 1;
+
+    // reads the bundle through the FileSystem (mapped, or in place in the pak) and checks that every offset in it stays inside the file
+    bool open(const std::string& path, std::string& error);
+    void close();
+
+    bool isOpen() const { return header != nullptr; }
+    std::size_t size() const { return header ? header->levelCount : 0; }
+
+    LevelView level(std::size_t index) const;
+    std::string_view name(std::size_t index) const;
+    uint32_t sourceHash(std::size_t index) const { return levels[index].sourceHash; }
+
+    struct Source
+    {
+        std::string name;
+        std::string contents; // the json file
+        Level level;
+    };
+
+    // used by the bundler tool
+    static bool write(const std::string& path, const std::vector<Source>& sources, std::string& error);
+
+private:
+    std::string_view string(const BundleString& str) const;
+
+    FileData file;
+
+    const BundleHeader* header = nullptr;
+    const BundleLevel* levels = nullptr;
+};
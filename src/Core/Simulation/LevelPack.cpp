@@ -0,0 +1,61 @@
+#include "LevelPack.h"
+
+#include <algorithm>
+
+#include "Core/FileSystem.h"
+#include "Core/Simulation/Replay.h"
+
+bool LevelPack::openBundle(const std::string& path, std::string& error)
+{
+    files.clear();
+
+    return bundle.open(path, error);
+}
+
+void LevelPack::openFiles(std::vector<std::string> levelFiles)
+{
+    bundle.close();
+
+    files = std::move(levelFiles);
+    std::sort(files.begin(), files.end());
+}
+
+bool LevelPack::get(std::size_t index, LevelView& level, uint32_t& sourceHash, std::string& error)
+{
+    if (index >= size())
+    {
+        error = "there is no level " + std::to_string(index);
+        return false;
+    }
+
+    if (isBundle())
+    {
+        // already checked when the bundle was opened, nothing can go wrong here
+        level = bundle.level(index);
+        sourceHash = bundle.sourceHash(index);
+        return true;
+    }
+
+    FileData file;
+    if (!FileSystem::read(files[index], file))
+    {
+        error = "can't open " + files[index];
+        return false;
+    }
+
+    if (!parseLevel(file.text(), current, error))
+        return false;
+
+    level = current;
+    sourceHash = Replay::hashLevel(file.text());
+
+    return true;
+}
+
+std::string LevelPack::name(std::size_t index) const
+{
+    if (isBundle())
+        return std::string(bundle.name(index));
+
+    return files[index];
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Core/Simulation/Level.h"
+#include "Core/Simulation/LevelBundle.h"
+
+// the levels the game plays, in order. Either a compiled bundle (fast, zero-copy) or a list of json
+// files that get parsed when they're loaded, so levels can still be edited without rebuilding anything.
+class LevelPack
+{
+public:
+    bool openBundle(const std::string& path, std::string& error);
+    void openFiles(std::vector<std::string> files); // sorted into play order
+
+    bool isBundle() const { return bundle.isOpen(); }
+    std::size_t size() const { return isBundle() ? bundle.size() : files.size(); }
+
+    // the view stays valid until the next get() or open. sourceHash is Replay::hashLevel of the level's json.
+    bool get(std::size_t index, LevelView& level, uint32_t& sourceHash, std::string& error);
+
+    std::string name(std::size_t index) const;
+
+private:
+    LevelBundle bundle;
+
+    std::vector<std::string> files;
+    Level current; // last level parsed from files, views point into it
+};
@@ -0,0 +1,349 @@
+#include "Replay.h"
+
+#include <fstream>
+
+#include "Core/Simulation/Simulation.h"
+
+static constexpr std::string_view MAGIC = "OREP";
+
+// index = the 2 bits stored in an event
+static constexpr std::array<Eye, 4> EYES = { Eye::NONE, Eye::CIRCLE, Eye::SQUARE, Eye::TRIANGLE };
+
+static uint8_t eyeIndex(Eye eye)
+{
+    for (uint8_t i = 0; i < EYES.size(); i++)
+    {
+        if (EYES[i] == eye)
+            return i;
+    }
+
+    return 0;
+}
+
+uint32_t Replay::hashLevel(std::string_view fileContents)
+{
+    // FNV-1a, skipping \r so it doesn't matter how the file was read or which line endings it has
+    uint32_t hash = 2166136261u;
+
+    for (char c : fileContents)
+    {
+        if (c == '\r')
+            continue;
+
+        hash ^= uint8_t(c);
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+bool Replay::read(std::string_view data, Replay& replay, std::string& error)
+{
+    if (data.size() < MAGIC.size() + 2 || data.substr(0, MAGIC.size()) != MAGIC)
+    {
+        error = "not a replay file";
+        return false;
+    }
+
+    if (uint8_t(data[MAGIC.size()]) != VERSION)
+    {
+        error = "unsupported replay version " + std::to_string(uint8_t(data[MAGIC.size()]));
+        return false;
+    }
+
+    replay.flags = uint8_t(data[MAGIC.size() + 1]);
+    replay.entries.clear();
+
+    std::size_t offset = MAGIC.size() + 2;
+
+    auto readVarint = [&](uint32_t& value)
+    {
+        value = 0;
+
+        for (int shift = 0; shift < 35; shift += 7)
+        {
+            if (offset >= data.size())
+                return false;
+
+            uint8_t byte = data[offset++];
+            value |= uint32_t(byte & 0x7F) << shift;
+
+            if (!(byte & 0x80))
+                return true;
+        }
+
+        return false; // too long for 32 bits
+    };
+
+    uint32_t tick = 0;
+    uint32_t ms = 0;
+
+    while (offset < data.size())
+    {
+        uint8_t header = data[offset++];
+
+        ReplayEntry entry;
+        entry.type = ReplayEvent(header & 7);
+
+        uint8_t arg = header >> 3;
+
+        uint32_t tickDelta, msDelta;
+        if (entry.type > ReplayEvent::END || !readVarint(tickDelta) || !readVarint(msDelta))
+        {
+            error = "corrupt event at byte " + std::to_string(offset);
+            return false;
+        }
+
+        tick += tickDelta;
+        ms += msDelta;
+        entry.tick = tick;
+        entry.ms = ms;
+
+        switch (entry.type)
+        {
+        case ReplayEvent::LEVEL:
+        {
+            uint32_t level;
+            if (!readVarint(level) || offset + 4 > data.size())
+            {
+                error = "corrupt level event at byte " + std::to_string(offset);
+                return false;
+            }
+
+            entry.level = int(level);
+
+            for (int i = 0; i < 4; i++)
+                entry.levelHash |= uint32_t(uint8_t(data[offset++])) << (8 * i);
+            break;
+        }
+
+        case ReplayEvent::BIND:
+            entry.eye = EYES[arg & 3];
+            entry.control = ALL_CONTROLS[arg >> 2];
+            break;
+
+        case ReplayEvent::POKE:
+            entry.eye = EYES[arg & 3];
+            break;
+
+        default:
+            break;
+        }
+
+        replay.entries.push_back(entry);
+
+        if (entry.type == ReplayEvent::END)
+        {
+            if (offset != data.size())
+            {
+                error = "data after the end of the replay";
+                return false;
+            }
+
+            return true;
+        }
+    }
+
+    error = "replay is cut off";
+    return false;
+}
+
+void ReplayRecorder::start(bool speedrun)
+{
+    active = true;
+
+    bytes.assign(MAGIC.begin(), MAGIC.end());
+    bytes.push_back(Replay::VERSION);
+    bytes.push_back(speedrun ? Replay::FLAG_SPEEDRUN : 0);
+
+    ticks = lastTick = lastMs = 0;
+    startTime = std::chrono::steady_clock::now();
+}
+
+void ReplayRecorder::writeVarint(uint32_t value)
+{
+    while (value >= 0x80)
+    {
+        bytes.push_back(uint8_t(value) | 0x80);
+        value >>= 7;
+    }
+
+    bytes.push_back(uint8_t(value));
+}
+
+void ReplayRecorder::event(ReplayEvent type, uint8_t arg)
+{
+    auto ms = uint32_t(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count());
+
+    bytes.push_back(uint8_t(type) | arg << 3);
+    writeVarint(ticks - lastTick);
+    writeVarint(ms - lastMs);
+
+    lastTick = ticks;
+    lastMs = ms;
+}
+
+void ReplayRecorder::level(int id, uint32_t levelHash)
+{
+    if (!active)
+        return;
+
+    event(ReplayEvent::LEVEL, 0);
+    writeVarint(uint32_t(id));
+
+    for (int i = 0; i < 4; i++)
+        bytes.push_back(uint8_t(levelHash >> (8 * i)));
+}
+
+void ReplayRecorder::reset()
+{
+    if (active)
+        event(ReplayEvent::RESET, 0);
+}
+
+void ReplayRecorder::bind(Eye eye, Control control)
+{
+    if (active)
+        event(ReplayEvent::BIND, eyeIndex(eye) | controlIndex(control) << 2);
+}
+
+void ReplayRecorder::poke(Eye eye)
+{
+    if (active)
+        event(ReplayEvent::POKE, eyeIndex(eye));
+}
+
+void ReplayRecorder::undo()
+{
+    if (active)
+        event(ReplayEvent::UNDO, 0);
+}
+
+bool ReplayRecorder::save(const std::string& path) const
+{
+    if (!active)
+        return false;
+
+    // finish a copy, so we can keep recording
+    ReplayRecorder finished = *this;
+    finished.event(ReplayEvent::END, 0);
+
+    std::ofstream file(path, std::ios::binary);
+    file.write((const char*)finished.bytes.data(), std::streamsize(finished.bytes.size()));
+
+    return bool(file);
+}
+
+ReplayResult playReplay(const Replay& replay, LevelPack& levels)
+{
+    ReplayResult result;
+
+    const bool speedrun = replay.flags & Replay::FLAG_SPEEDRUN;
+
+    LevelView level;
+    Simulation sim;
+
+    int levelID = -1;
+    bool won = false;  // the current level was beaten, the next one may load
+    bool died = false; // in speedrun mode dying sends you back to level 0
+
+    uint32_t executed = 0;
+
+    auto fail = [&](const ReplayEntry& entry, const std::string& why)
+    {
+        result.error = why + " (tick " + std::to_string(entry.tick) + ")";
+        result.lastLevel = levelID;
+        result.ticks = executed;
+        return result;
+    };
+
+    for (const ReplayEntry& entry : replay.entries)
+    {
+        // catch the simulation up to when this happened
+        for (; executed < entry.tick; executed++)
+        {
+            switch (sim.tick())
+            {
+            case MoveResult::WON:
+                if (!won)
+                    result.levelsBeaten++;
+
+                won = true;
+                break;
+
+            case MoveResult::DIED:
+            case MoveResult::DIED_INK:
+                result.deaths++;
+                died = true;
+                break;
+
+            default:
+                break;
+            }
+        }
+
+        if (levelID < 0 && entry.type != ReplayEvent::LEVEL && entry.type != ReplayEvent::END)
+            return fail(entry, "input before any level was loaded");
+
+        switch (entry.type)
+        {
+        case ReplayEvent::LEVEL:
+        {
+            if (levelID < 0)
+                result.startLevel = entry.level;
+            else if (!(won && entry.level == levelID + 1) && !(speedrun && died && entry.level == 0))
+                return fail(entry, "level " + std::to_string(entry.level) + " loaded without beating level " + std::to_string(levelID));
+
+            if (entry.level < 0 || entry.level >= int(levels.size()))
+                return fail(entry, "there is no level " + std::to_string(entry.level));
+
+            uint32_t levelHash;
+            std::string error;
+            if (!levels.get(entry.level, level, levelHash, error))
+                return fail(entry, levels.name(entry.level) + " is broken: " + error);
+
+            if (levelHash != entry.levelHash)
+                return fail(entry, levels.name(entry.level) + " isn't the level that was played");
+
+            if (speedrun)
+                level.controls = "*,()^_<>"; // same as GUIScene::setLevel
+
+            sim.load(Board::fromLevel(level));
+
+            levelID = entry.level;
+            won = false;
+            died = false;
+            break;
+        }
+
+        case ReplayEvent::RESET:
+            sim.reset();
+            break;
+
+        case ReplayEvent::BIND:
+            if (level.controls.find(char(entry.control)) == std::string_view::npos || !sim.bind(entry.eye, entry.control))
+                return fail(entry, "can't bind that control");
+            break;
+
+        case ReplayEvent::POKE:
+            sim.poke(entry.eye);
+            break;
+
+        case ReplayEvent::UNDO:
+            if (!sim.undo())
+                return fail(entry, "nothing to undo");
+            break;
+
+        case ReplayEvent::END:
+            result.valid = true;
+            result.ms = entry.ms;
+            break;
+        }
+    }
+
+    result.lastLevel = levelID;
+    result.finished = won && levelID == int(levels.size()) - 1;
+    result.ticks = executed;
+
+    return result;
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Core/Simulation/Level.h"
+#include "Core/Simulation/LevelPack.h"
+
+// a replay is "OREP", a version byte and a flags byte, followed by events.
+// Every event is one byte (type in the low 3 bits, eye/control in the high 5) followed by
+// varints of the world ticks and milliseconds since the previous event. LEVEL events also
+// carry the level index and a hash of the level file so the replay can't be played on other levels.
+// Level changes and resets are recorded when they happen instead of being re-derived from timers,
+// so playback only depends on the order of events and ticks.
+enum class ReplayEvent : uint8_t
+{
+    LEVEL,
+    RESET,
+    BIND,
+    POKE,
+    UNDO,
+    END
+};
+
+struct ReplayEntry
+{
+    ReplayEvent type = ReplayEvent::END;
+
+    uint32_t tick = 0; // world ticks before this event
+    uint32_t ms = 0;   // since the recording started
+
+    Eye eye = Eye::NONE;
+    Control control = Control::NONE;
+
+    int level = 0;
+    uint32_t levelHash = 0;
+};
+
+struct Replay
+{
+    static constexpr uint8_t VERSION = 1;
+    static constexpr uint8_t FLAG_SPEEDRUN = 1;
+
+    uint8_t flags = 0;
+    std::vector<ReplayEntry> entries; // always ends with END
+
+    // returns false and explains why in error if data isn't a replay
+    static bool read(std::string_view data, Replay& replay, std::string& error);
+
+    static uint32_t hashLevel(std::string_view fileContents);
+};
+
+class ReplayRecorder
+{
+public:
+    void start(bool speedrun);
+    bool recording() const { return active; }
+
+    void tick() { ticks++; }
+
+    void level(int id, uint32_t levelHash); // levelHash is Replay::hashLevel of the level's json
+    void reset();
+    void bind(Eye eye, Control control);
+    void poke(Eye eye);
+    void undo();
+
+    // writes everything so far, can be called again later as the recording goes on
+    bool save(const std::string& path) const;
+
+private:
+    void event(ReplayEvent type, uint8_t arg);
+    void writeVarint(uint32_t value);
+
+    bool active = false;
+    std::vector<uint8_t> bytes;
+
+    uint32_t ticks = 0;
+    uint32_t lastTick = 0;
+    uint32_t lastMs = 0;
+
+    std::chrono::steady_clock::time_point startTime;
+};
+
+struct ReplayResult
+{
+    bool valid = false;
+    std::string error; // why it isn't valid
+
+    int startLevel = 0;
+    int lastLevel = 0;
+    int levelsBeaten = 0;
+    int deaths = 0;
+    bool finished = false; // beat the last level
+
+    uint32_t ticks = 0;
+    uint32_t ms = 0;
+};
+
+// runs the replay through the simulation without any rendering or waiting, checking that every
+// level change was earned. levels must be the same pack the game would play.
+ReplayResult playReplay(const Replay& replay, LevelPack& levels);
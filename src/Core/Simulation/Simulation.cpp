@@ -0,0 +1,150 @@
+#include "Simulation.h"
+
+Simulation::Simulation(const Board& board)
+{
+    load(board);
+}
+
+void Simulation::load(const Board& _board)
+{
+    board = _board;
+    pos = board.start;
+}
+
+void Simulation::reset()
+{
+    pos = board.start;
+    movable = true;
+
+    inputQueue.clear();
+    pastPositions.clear();
+
+    bindCount = 0;
+}
+
+bool Simulation::bind(Eye eye, Control control)
+{
+    if (control == Control::NONE || controlBound(control))
+        return false; // can't bind control twice!
+
+    if (eye != Eye::NONE)
+        binds[bindCount++] = KeyBinding(eye, control);
+
+    pastPositions.clear(); // binding wipes the undo history
+
+    return true;
+}
+
+bool Simulation::controlBound(Control control) const
+{
+    for (const KeyBinding& bind : bindings())
+    {
+        if (bind.m_control == control)
+            return true;
+    }
+
+    return false;
+}
+
+std::span<const KeyBinding> Simulation::bindings() const
+{
+    return std::span<const KeyBinding>(binds.data(), bindCount);
+}
+
+bool Simulation::poke(Eye eye)
+{
+    // forget the oldest move rather than refusing the poke
+    if (pastPositions.full())
+        pastPositions.pop_front();
+
+    pastPositions.push_back(pos);
+
+    bool fits = true;
+
+    for (const KeyBinding& bind : bindings())
+    {
+        if (bind.m_eye == eye)
+            fits &= inputQueue.push_back(bind.m_control);
+    }
+
+    return fits;
+}
+
+bool Simulation::undo()
+{
+    if (!movable || pastPositions.empty())
+        return false;
+
+    pos = pastPositions.back();
+    pastPositions.pop_back();
+
+    return true;
+}
+
+MoveResult Simulation::tick()
+{
+    if (inputQueue.empty())
+        return MoveResult::NONE;
+
+    Control input = inputQueue.front();
+    inputQueue.pop_front();
+
+    return tryMove(input);
+}
+
+GridPos Simulation::applyControl(GridPos pos, Control ctrl)
+{
+    const ControlMove move = controlToMove(ctrl);
+
+    for (int i = 0; i < move.steps; i++)
+        pos += move.dir;
+
+    return pos;
+}
+
+MoveResult Simulation::step(const Board& board, GridPos& pos, Control input, bool lastInput)
+{
+    const ControlMove move = controlToMove(input);
+
+    GridPos newPos = pos;
+
+    for (int i = 0; i < move.steps; i++)
+    {
+        newPos += move.dir;
+
+        // you only win by ending the last queued input on the goal, otherwise it's just floor
+        if (newPos == board.goal && i == move.steps - 1 && lastInput)
+        {
+            pos = newPos;
+
+            return MoveResult::WON;
+        }
+
+        char tile = board.tileAt(newPos);
+
+        // dashes jump over ink with their first step
+        if (tile != ' ' && !(tile == 'H' && i == 0 && move.steps == 2))
+        {
+            pos = newPos;
+
+            return tile == 'H' ? MoveResult::DIED_INK : MoveResult::DIED;
+        }
+    }
+
+    pos = newPos;
+
+    return MoveResult::MOVED;
+}
+
+MoveResult Simulation::tryMove(Control input)
+{
+    if (!movable)
+        return MoveResult::BLOCKED;
+
+    MoveResult result = step(board, pos, input, inputQueue.empty());
+
+    if (result != MoveResult::MOVED)
+        movable = false;
+
+    return result;
+}
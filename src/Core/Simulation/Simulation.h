@@ -0,0 +1,141 @@
+#pragma once
+
+#include <array>
+#include <span>
+#include <string_view>
+
+#include "Core/Simulation/FixedQueue.h"
+#include "Core/Simulation/Level.h"
+#include "KeyBinding.h"
+
+// every control a level can unlock, in the order used for control indices and masks
+constexpr std::array<Control, 8> ALL_CONTROLS = {
+    Control::MOVE_UP, Control::MOVE_DOWN, Control::MOVE_LEFT, Control::MOVE_RIGHT,
+    Control::DASH_UP, Control::DASH_DOWN, Control::DASH_LEFT, Control::DASH_RIGHT
+};
+
+// a control moves the player `steps` tiles in direction `dir`
+struct ControlMove
+{
+    GridPos dir;
+    int steps = 0;
+};
+
+constexpr std::array<ControlMove, 8> CONTROL_MOVES = { {
+    {{ 0, -1}, 1}, // MOVE_UP
+    {{ 0,  1}, 1}, // MOVE_DOWN
+    {{-1,  0}, 1}, // MOVE_LEFT
+    {{ 1,  0}, 1}, // MOVE_RIGHT
+    {{ 0, -1}, 2}, // DASH_UP
+    {{ 0,  1}, 2}, // DASH_DOWN
+    {{-1,  0}, 2}, // DASH_LEFT
+    {{ 1,  0}, 2}, // DASH_RIGHT
+} };
+
+// index of ctrl in ALL_CONTROLS, -1 for NONE and garbage
+constexpr int controlIndex(Control ctrl)
+{
+    for (int i = 0; i < int(ALL_CONTROLS.size()); i++)
+    {
+        if (ALL_CONTROLS[i] == ctrl)
+            return i;
+    }
+
+    return -1;
+}
+
+constexpr ControlMove controlToMove(Control ctrl)
+{
+    int index = controlIndex(ctrl);
+
+    return index < 0 ? ControlMove{} : CONTROL_MOVES[index];
+}
+
+// what happened when the simulation processed an input
+enum class MoveResult
+{
+    NONE,     // nothing was queued
+    BLOCKED,  // the player already won or died
+    MOVED,
+    WON,
+    DIED,     // walked into a wall
+    DIED_INK  // walked into an ink hole
+};
+
+// the playable part of a level. Tiles are not owned, the level they come from must outlive the board.
+struct Board
+{
+    std::string_view tiles;
+    int width = 0;
+    int height = 0;
+
+    GridPos start;
+    GridPos goal;
+
+    static Board fromLevel(const LevelView& level)
+    {
+        return Board{ level.data, level.rowLength, int(level.data.size()) / level.rowLength, level.start, level.goal };
+    }
+
+    // anything off the grid counts as a wall
+    char tileAt(const GridPos& pos) const
+    {
+        if (pos.x < 0 || pos.y < 0 || pos.x >= width || pos.y >= height)
+            return 'W';
+
+        return tiles[pos.x + pos.y * width];
+    }
+};
+
+// headless puzzle rules, no GL and no allocations after construction.
+// GUIScene drives one of these and only takes care of presentation.
+class Simulation
+{
+public:
+    static constexpr std::size_t MAX_QUEUED_INPUTS = 64;
+    static constexpr std::size_t MAX_UNDO_STEPS = 256;
+
+    Simulation() = default;
+    explicit Simulation(const Board& board);
+
+    // swaps the board and moves the player to its start. Bindings and queued inputs are kept, call reset() to start over.
+    void load(const Board& board);
+    void reset();
+
+    // returns false if the control can't be bound. Binding to Eye::NONE is accepted but does nothing.
+    bool bind(Eye eye, Control control);
+    bool controlBound(Control control) const;
+    std::span<const KeyBinding> bindings() const;
+
+    // queue every control bound to the eye, returns false if some had to be dropped
+    bool poke(Eye eye);
+    bool undo();
+
+    // process one queued input
+    MoveResult tick();
+
+    GridPos playerPos() const { return pos; }
+    bool canMove() const { return movable; }
+    std::size_t queuedInputs() const { return inputQueue.size(); }
+    const Board& getBoard() const { return board; }
+
+    // where a control would take you, ignoring the level entirely
+    static GridPos applyControl(GridPos pos, Control ctrl);
+
+    // the movement rule itself: moves pos by one input. Only the last queued input can win.
+    static MoveResult step(const Board& board, GridPos& pos, Control input, bool lastInput);
+
+private:
+    MoveResult tryMove(Control input);
+
+    Board board;
+
+    GridPos pos;
+    bool movable = true;
+
+    FixedQueue<Control, MAX_QUEUED_INPUTS> inputQueue;
+    FixedQueue<GridPos, MAX_UNDO_STEPS> pastPositions;
+
+    std::array<KeyBinding, ALL_CONTROLS.size()> binds{};
+    std::size_t bindCount = 0;
+};
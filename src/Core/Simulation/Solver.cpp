@@ -0,0 +1,448 @@
+#include "Solver.h"
+
+#include <algorithm>
+
+static constexpr uint32_t NO_PARENT = UINT32_MAX;
+
+Solver::Solver(const Board& _board, std::string_view controls, std::size_t _maxNodes)
+    : board(_board), maxNodes(_maxNodes)
+{
+    for (char c : controls)
+    {
+        int index = controlIndex(Control(c));
+
+        if (index >= 0)
+            levelControls |= 1 << index;
+    }
+
+    wordsPerBoard = (std::size_t(std::max(board.width, 0)) * std::max(board.height, 0) + 63) / 64;
+}
+
+SolveResult Solver::solve()
+{
+    SolveResult result;
+
+    if (board.width <= 0 || board.height <= 0)
+        return result;
+
+    computeDistances();
+
+    uint32_t startCell = board.start.y * board.width + board.start.x;
+
+    int h = goalDistance[startCell];
+    if (h >= UNREACHABLE)
+        return result;
+
+    uint32_t root = internBindings(Bindings{});
+
+    // root slots map to themselves: 0 | 1 << 2 | 2 << 4
+    push(Node{ root, startCell, NO_PARENT, 0, 0, 0, 0b100100, false }, h);
+
+    for (std::size_t f = 0; f < buckets.size(); f++)
+    {
+        while (!buckets[f].empty())
+        {
+            // depth first within a bucket, gets to the goal sooner
+            uint32_t index = buckets[f].back();
+            buckets[f].pop_back();
+
+            const Node node = nodes[index];
+
+            if (node.won)
+            {
+                result.status = SolveStatus::SOLVED;
+                result.moves = node.moves;
+                result.steps = reconstruct(index);
+                return result;
+            }
+
+            if (!node.requeued)
+            {
+                // something at least as good may have been expanded since this was queued
+                if (dominated(node.bindings, node.cell))
+                    continue;
+
+                markVisited(node.bindings, node.cell);
+                result.statesExpanded++;
+            }
+
+            if (nodes.size() >= maxNodes)
+            {
+                result.status = SolveStatus::GAVE_UP;
+                return result;
+            }
+
+            expandF = int(f);
+            nextF = UNREACHABLE;
+
+            expand(index);
+
+            if (nextF < UNREACHABLE)
+            {
+                Node again = node;
+                again.requeued = true;
+
+                push(again, nextF);
+            }
+        }
+    }
+
+    return result;
+}
+
+Solver::PackedList Solver::listAppend(PackedList list, int ctrl)
+{
+    int length = listLength(list);
+
+    return (list & ~0xFu) | (PackedList(ctrl) << (4 + 3 * length)) | PackedList(length + 1);
+}
+
+Solver::Bindings Solver::canonicalize(const Bindings& bindings, uint8_t* fromParent)
+{
+    // lists sorted by packed value, unbound eyes last
+    std::array<uint8_t, 3> order = { 0, 1, 2 };
+
+    auto sortPair = [&](int a, int b)
+    {
+        if (bindings.lists[order[a]] < bindings.lists[order[b]])
+            std::swap(order[a], order[b]);
+    };
+
+    sortPair(0, 1);
+    sortPair(1, 2);
+    sortPair(0, 1);
+
+    Bindings canonical;
+
+    for (int i = 0; i < 3; i++)
+        canonical.lists[i] = bindings.lists[order[i]];
+
+    if (fromParent)
+        *fromParent = order[0] | order[1] << 2 | order[2] << 4;
+
+    return canonical;
+}
+
+uint32_t Solver::internBindings(const Bindings& bindings)
+{
+    // keep the table at most half full
+    if (bindingsTable.size() < bindingsList.size() * 2 + 2)
+    {
+        bindingsTable.assign(std::max<std::size_t>(bindingsTable.size() * 2, 1024), NO_BINDINGS);
+
+        for (uint32_t i = 0; i < bindingsList.size(); i++)
+        {
+            std::size_t slot = hashBindings(bindingsList[i]) & (bindingsTable.size() - 1);
+
+            while (bindingsTable[slot] != NO_BINDINGS)
+                slot = (slot + 1) & (bindingsTable.size() - 1);
+
+            bindingsTable[slot] = i;
+        }
+    }
+
+    std::size_t slot = hashBindings(bindings) & (bindingsTable.size() - 1);
+
+    for (; bindingsTable[slot] != NO_BINDINGS; slot = (slot + 1) & (bindingsTable.size() - 1))
+    {
+        if (bindingsList[bindingsTable[slot]] == bindings)
+            return bindingsTable[slot];
+    }
+
+    const uint32_t id = uint32_t(bindingsList.size());
+    bindingsTable[slot] = id;
+
+    bindingsList.push_back(bindings);
+    visitedBits.resize(visitedBits.size() + wordsPerBoard);
+    prefixRanges.emplace_back();
+
+    // our prefixes are ourselves plus the prefixes of each set with one control taken off the end
+    std::vector<uint32_t> prefixes = { id };
+
+    for (int slot = 0; slot < 3; slot++)
+    {
+        int length = listLength(bindings.lists[slot]);
+
+        if (length == 0)
+            continue;
+
+        Bindings shorter = bindings;
+        shorter.lists[slot] = length == 1 ? 0 : (shorter.lists[slot] & ((PackedList(1) << (4 + 3 * (length - 1))) - 1) & ~0xFu) | PackedList(length - 1);
+
+        uint32_t shorterId = internBindings(canonicalize(shorter));
+
+        auto [begin, end] = prefixRanges[shorterId];
+        prefixes.insert(prefixes.end(), prefixIds.begin() + begin, prefixIds.begin() + end);
+    }
+
+    std::sort(prefixes.begin(), prefixes.end());
+    prefixes.erase(std::unique(prefixes.begin(), prefixes.end()), prefixes.end());
+
+    prefixRanges[id] = { uint32_t(prefixIds.size()), uint32_t(prefixIds.size() + prefixes.size()) };
+    prefixIds.insert(prefixIds.end(), prefixes.begin(), prefixes.end());
+
+    return id;
+}
+
+bool Solver::visited(uint32_t bindings, uint32_t cell) const
+{
+    return (visitedBits[bindings * wordsPerBoard + cell / 64] >> (cell % 64)) & 1;
+}
+
+void Solver::markVisited(uint32_t bindings, uint32_t cell)
+{
+    visitedBits[bindings * wordsPerBoard + cell / 64] |= uint64_t(1) << (cell % 64);
+}
+
+bool Solver::dominated(uint32_t bindings, uint32_t cell) const
+{
+    auto [begin, end] = prefixRanges[bindings];
+
+    for (uint32_t i = begin; i < end; i++)
+    {
+        if (visited(prefixIds[i], cell))
+            return true;
+    }
+
+    return false;
+}
+
+void Solver::computeDistances()
+{
+    const int cells = board.width * board.height;
+
+    // cells one relaxed poke away from each cell. Where a poke ends only depends on which controls it
+    // ran, not their order, so each start cell has at most one end per subset of controls.
+    std::vector<uint32_t> targets;
+    std::vector<uint32_t> targetStart(cells + 1);
+    std::vector<bool> winsInOne(cells);
+
+    for (int cell = 0; cell < cells; cell++)
+    {
+        targetStart[cell] = uint32_t(targets.size());
+
+        if (board.tiles[cell] != ' ')
+            continue;
+
+        std::array<GridPos, 256> ends;
+        std::array<bool, 256> seen{};
+        std::vector<uint8_t> stack = { 0 };
+
+        ends[0] = GridPos{ cell % board.width, cell / board.width };
+        seen[0] = true;
+
+        while (!stack.empty())
+        {
+            uint8_t mask = stack.back();
+            stack.pop_back();
+
+            for (int ctrl = 0; ctrl < int(ALL_CONTROLS.size()); ctrl++)
+            {
+                if (!(levelControls & ~mask & (1 << ctrl)))
+                    continue;
+
+                GridPos pos = ends[mask];
+                MoveResult result = Simulation::step(board, pos, ALL_CONTROLS[ctrl], true);
+
+                if (result == MoveResult::WON)
+                    winsInOne[cell] = true;
+
+                uint8_t newMask = mask | (1 << ctrl);
+
+                if (result != MoveResult::MOVED || seen[newMask])
+                    continue;
+
+                seen[newMask] = true;
+                ends[newMask] = pos;
+                stack.push_back(newMask);
+                targets.push_back(pos.y * board.width + pos.x);
+            }
+        }
+    }
+
+    targetStart[cells] = uint32_t(targets.size());
+
+    goalDistance.assign(cells, UNREACHABLE);
+
+    for (int cell = 0; cell < cells; cell++)
+    {
+        if (winsInOne[cell])
+            goalDistance[cell] = 1;
+    }
+
+    // relax until nothing changes, levels are small enough that this beats building the reverse graph
+    bool changed = true;
+
+    while (changed)
+    {
+        changed = false;
+
+        for (int cell = 0; cell < cells; cell++)
+        {
+            for (uint32_t i = targetStart[cell]; i < targetStart[cell + 1]; i++)
+            {
+                if (goalDistance[targets[i]] + 1 < goalDistance[cell])
+                {
+                    goalDistance[cell] = goalDistance[targets[i]] + 1;
+                    changed = true;
+                }
+            }
+        }
+    }
+}
+
+void Solver::expand(uint32_t nodeIndex)
+{
+    const Node node = nodes[nodeIndex];
+    const Bindings bindings = bindingsList[node.bindings];
+    const GridPos pos{ int(node.cell % board.width), int(node.cell / board.width) };
+
+    uint8_t used = 0;
+    for (PackedList list : bindings.lists)
+    {
+        for (int i = 0; i < listLength(list); i++)
+            used |= 1 << listAt(list, i);
+    }
+
+    const uint8_t available = levelControls & ~used;
+
+    bool triedUnbound = false;
+
+    for (int slot = 0; slot < 3; slot++)
+    {
+        PackedList list = bindings.lists[slot];
+        int length = listLength(list);
+
+        if (length == 0)
+        {
+            // all unbound eyes are the same, only try one of them
+            if (triedUnbound)
+                continue;
+
+            triedUnbound = true;
+        }
+
+        GridPos listPos = pos;
+        MoveResult result = MoveResult::MOVED;
+
+        for (int i = 0; i < length && result == MoveResult::MOVED; i++)
+            result = Simulation::step(board, listPos, ALL_CONTROLS[listAt(list, i)], i == length - 1);
+
+        if (result == MoveResult::DIED || result == MoveResult::DIED_INK)
+            continue; // anything we append would die the same way
+
+        if (length > 0)
+            emit(nodeIndex, slot, list, listPos, 0, result == MoveResult::WON);
+
+        extend(nodeIndex, slot, list, listPos, available, 0);
+    }
+}
+
+void Solver::extend(uint32_t nodeIndex, int slot, PackedList list, const GridPos& pos, uint8_t available, PackedList appended)
+{
+    for (int ctrl = 0; ctrl < int(ALL_CONTROLS.size()); ctrl++)
+    {
+        if (!(available & (1 << ctrl)))
+            continue;
+
+        GridPos newPos = pos;
+        MoveResult result = Simulation::step(board, newPos, ALL_CONTROLS[ctrl], true);
+
+        if (result == MoveResult::DIED || result == MoveResult::DIED_INK)
+            continue;
+
+        PackedList newList = listAppend(list, ctrl);
+        PackedList newAppended = listAppend(appended, ctrl);
+
+        emit(nodeIndex, slot, newList, newPos, newAppended, result == MoveResult::WON);
+
+        // walking on past the goal can't beat winning right here
+        if (result == MoveResult::MOVED)
+            extend(nodeIndex, slot, newList, newPos, available & ~(1 << ctrl), newAppended);
+    }
+}
+
+void Solver::emit(uint32_t nodeIndex, int slot, PackedList list, const GridPos& pos, PackedList appended, bool won)
+{
+    const uint16_t moves = nodes[nodeIndex].moves + 1;
+
+    // children outside the current bucket wait for the parent to be expanded again
+    auto inBucket = [&](int f)
+    {
+        if (f > expandF)
+            nextF = std::min(nextF, f);
+
+        return f == expandF;
+    };
+
+    if (won)
+    {
+        if (inBucket(moves))
+            push(Node{ 0, 0, nodeIndex, appended, moves, uint8_t(slot), 0b100100, true }, moves);
+
+        return;
+    }
+
+    uint32_t cell = pos.y * board.width + pos.x;
+
+    int h = goalDistance[cell];
+    if (h >= UNREACHABLE || !inBucket(moves + h))
+        return;
+
+    Bindings bindings = bindingsList[nodes[nodeIndex].bindings];
+    bindings.lists[slot] = list;
+
+    uint8_t fromParent = 0;
+    Bindings canonical = canonicalize(bindings, &fromParent);
+
+    uint32_t id = internBindings(canonical);
+
+    // the full dominance check waits until the node is expanded
+    if (visited(id, cell))
+        return;
+
+    push(Node{ id, cell, nodeIndex, appended, moves, uint8_t(slot), fromParent, false }, moves + h);
+}
+
+void Solver::push(const Node& node, int f)
+{
+    if (f >= int(buckets.size()))
+        buckets.resize(f + 1);
+
+    buckets[f].push_back(uint32_t(nodes.size()));
+    nodes.push_back(node);
+}
+
+std::vector<SolutionStep> Solver::reconstruct(uint32_t nodeIndex) const
+{
+    std::vector<uint32_t> path;
+
+    for (uint32_t i = nodeIndex; nodes[i].parent != NO_PARENT; i = nodes[i].parent)
+        path.push_back(i);
+
+    std::reverse(path.begin(), path.end());
+
+    // follow the real eye behind each canonical slot along the way
+    std::array<Eye, 3> eyes = { Eye::CIRCLE, Eye::SQUARE, Eye::TRIANGLE };
+
+    std::vector<SolutionStep> steps;
+
+    for (uint32_t i : path)
+    {
+        const Node& node = nodes[i];
+        Eye eye = eyes[node.eyeSlot];
+
+        for (int a = 0; a < listLength(node.appended); a++)
+            steps.push_back(SolutionStep{ SolutionStep::Type::BIND, eye, ALL_CONTROLS[listAt(node.appended, a)] });
+
+        steps.push_back(SolutionStep{ SolutionStep::Type::POKE, eye });
+
+        std::array<Eye, 3> nextEyes;
+        for (int j = 0; j < 3; j++)
+            nextEyes[j] = eyes[(node.fromParent >> (2 * j)) & 3];
+
+        eyes = nextEyes;
+    }
+
+    return steps;
+}
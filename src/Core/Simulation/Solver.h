@@ -0,0 +1,138 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "Core/Simulation/Simulation.h"
+
+enum class SolveStatus
+{
+    SOLVED,
+    UNSOLVABLE,
+    GAVE_UP // ran into the state limit
+};
+
+struct SolutionStep
+{
+    enum class Type { BIND, POKE };
+
+    Type type;
+    Eye eye;
+    Control control = Control::NONE; // only for BIND
+};
+
+struct SolveResult
+{
+    SolveStatus status = SolveStatus::UNSOLVABLE;
+
+    int moves = 0; // eye pokes, binding is free
+    std::vector<SolutionStep> steps;
+
+    std::size_t statesExpanded = 0;
+};
+
+// finds the fewest eye pokes that win a level, over every way of binding its controls to the three eyes.
+// Binding is deferred until right before the bound eye is poked (it's never better to bind earlier),
+// eyes are interchangeable so bindings are kept in a canonical order, and the search is A*.
+// The heuristic is the exact number of pokes needed if every poke could run any sequence of distinct
+// controls, which also proves most unsolvable levels before searching at all.
+// Visited states are a bitset over the board per distinct binding set, and a state is skipped if the
+// same tile was already expanded with a prefix of each eye's controls: that state can bind the rest
+// later and do everything this one can. An unbound eye can be given hundreds of thousands of control
+// sequences, so expanding a state only creates the children in the current f bucket and queues the
+// state again for the next f it has children for.
+// Small levels finish in milliseconds. Open 30x30 levels with all eight controls and solutions over a dozen
+// pokes can take seconds: most of what gets expanded there has every eye bound, and the heuristic only
+// knows about single tiles, not which bindings are left.
+class Solver
+{
+public:
+    static constexpr std::size_t DEFAULT_MAX_NODES = 8'000'000;
+
+    Solver(const Board& board, std::string_view controls, std::size_t maxNodes = DEFAULT_MAX_NODES);
+
+    SolveResult solve();
+
+private:
+    // up to 8 control indices, 4 bits of length followed by 3 bits per control
+    typedef uint32_t PackedList;
+
+    // controls bound to each eye, sorted so that permuting the eyes gives the same key
+    struct Bindings
+    {
+        std::array<PackedList, 3> lists{};
+
+        bool operator==(const Bindings& other) const = default;
+    };
+
+    static std::size_t hashBindings(const Bindings& b)
+    {
+        uint64_t h = (uint64_t(b.lists[0]) << 32) ^ (uint64_t(b.lists[1]) << 16) ^ b.lists[2];
+        h ^= h >> 33; h *= 0xff51afd7ed558ccdull; h ^= h >> 33;
+        return h;
+    }
+
+    struct Node
+    {
+        uint32_t bindings; // index into bindingsList
+        uint32_t cell;
+        uint32_t parent;
+        uint32_t appended; // PackedList of controls bound right before the poke
+        uint16_t moves;
+        uint8_t eyeSlot;   // poked eye, in the parent's canonical order
+        uint8_t fromParent; // 2 bits per eye: which parent slot each of our slots came from
+        bool won;
+        bool requeued = false; // already expanded once, generate the children with a higher f now
+    };
+
+    static int listLength(PackedList list) { return list & 0xF; }
+    static int listAt(PackedList list, int i) { return (list >> (4 + 3 * i)) & 7; }
+    static PackedList listAppend(PackedList list, int ctrl);
+
+    static Bindings canonicalize(const Bindings& bindings, uint8_t* fromParent = nullptr);
+
+    uint32_t internBindings(const Bindings& bindings);
+    bool visited(uint32_t bindings, uint32_t cell) const;
+    void markVisited(uint32_t bindings, uint32_t cell);
+    bool dominated(uint32_t bindings, uint32_t cell) const;
+
+    void computeDistances();
+
+    void expand(uint32_t nodeIndex);
+    void extend(uint32_t nodeIndex, int slot, PackedList list, const GridPos& pos, uint8_t available, PackedList appended);
+    void emit(uint32_t nodeIndex, int slot, PackedList list, const GridPos& pos, PackedList appended, bool won);
+
+    void push(const Node& node, int f);
+
+    std::vector<SolutionStep> reconstruct(uint32_t nodeIndex) const;
+
+    Board board;
+    uint8_t levelControls = 0; // bit mask over ALL_CONTROLS
+    std::size_t maxNodes;
+
+    // per cell, pokes to win when each poke may run any sequence of distinct controls. Never more than the real thing.
+    std::vector<int> goalDistance;
+
+    // open addressing, linear probing. Looked up for every generated state so it has to be flat.
+    std::vector<uint32_t> bindingsTable; // ids into bindingsList, NO_BINDINGS for empty slots
+    static constexpr uint32_t NO_BINDINGS = UINT32_MAX;
+    std::vector<Bindings> bindingsList;
+
+    // ids of every binding set made of prefixes of each list (itself included), interning a set interns these too
+    std::vector<uint32_t> prefixIds;
+    std::vector<std::pair<uint32_t, uint32_t>> prefixRanges; // per binding set, into prefixIds
+
+    std::size_t wordsPerBoard = 0;
+    std::vector<uint64_t> visitedBits;
+
+    std::vector<Node> nodes;
+    std::vector<std::vector<uint32_t>> buckets; // open list, indexed by f = moves + heuristic
+
+    // while expanding: the f being generated, and the lowest f above it that got skipped
+    int expandF = 0;
+    int nextF = 0;
+
+    static constexpr int UNREACHABLE = 1 << 20;
+};
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// a move only void() callable like Task, except anything up to BUFFER_SIZE bytes lives inside it
+// instead of on the heap. Lambdas capturing a few pointers, which is nearly all of them, never allocate
+class SmallTask
+{
+public:
+    static constexpr std::size_t BUFFER_SIZE = 4 * sizeof(void*);
+
+    SmallTask() = default;
+
+    template<typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, SmallTask>>>
+    SmallTask(F&& func)
+    {
+        typedef std::decay_t<F> Func;
+
+        if constexpr (fitsInline<Func>())
+        {
+            new (buffer) Func(std::forward<F>(func));
+            ops = &INLINE_OPS<Func>;
+        }
+        else
+        {
+            new (buffer) Func*(new Func(std::forward<F>(func)));
+            ops = &HEAP_OPS<Func>;
+        }
+    }
+
+    SmallTask(SmallTask&& other) noexcept
+    {
+        take(other);
+    }
+
+    SmallTask& operator=(SmallTask&& other) noexcept
+    {
+        if (this != &other)
+        {
+            reset();
+            take(other);
+        }
+
+        return *this;
+    }
+
+    SmallTask(const SmallTask&) = delete;
+    SmallTask& operator=(const SmallTask&) = delete;
+
+    ~SmallTask()
+    {
+        reset();
+    }
+
+    void operator()()
+    {
+        ops->invoke(buffer);
+    }
+
+    explicit operator bool() const
+    {
+        return ops != nullptr;
+    }
+
+    void reset()
+    {
+        if (ops)
+            ops->destroy(buffer);
+
+        ops = nullptr;
+    }
+
+    template<typename Func>
+    static constexpr bool fitsInline()
+    {
+        return sizeof(Func) <= BUFFER_SIZE && alignof(Func) <= alignof(std::max_align_t)
+            && std::is_nothrow_move_constructible_v<Func>;
+    }
+
+private:
+    struct Ops
+    {
+        void (*invoke)(void* buffer);
+        void (*move)(void* from, void* to); // leaves from destroyed
+        void (*destroy)(void* buffer);
+    };
+
+    template<typename Func>
+    static constexpr Ops INLINE_OPS = {
+        [](void* buffer) { (*std::launder(static_cast<Func*>(buffer)))(); },
+        [](void* from, void* to)
+        {
+            Func* func = std::launder(static_cast<Func*>(from));
+            new (to) Func(std::move(*func));
+            func->~Func();
+        },
+        [](void* buffer) { std::launder(static_cast<Func*>(buffer))->~Func(); }
+    };
+
+    // too big, the buffer just holds a pointer to it
+    template<typename Func>
+    static constexpr Ops HEAP_OPS = {
+        [](void* buffer) { (**static_cast<Func**>(buffer))(); },
+        [](void* from, void* to) { *static_cast<Func**>(to) = *static_cast<Func**>(from); },
+        [](void* buffer) { delete *static_cast<Func**>(buffer); }
+    };
+
+    void take(SmallTask& other)
+    {
+        if (other.ops)
+            other.ops->move(other.buffer, buffer);
+
+        ops = other.ops;
+        other.ops = nullptr;
+    }
+
+    alignas(std::max_align_t) unsigned char buffer[BUFFER_SIZE];
+    const Ops* ops = nullptr;
+};
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+// ring buffer for one thread handing things to one other thread. Neither side ever locks or allocates,
+// so the producer can't get stuck behind whatever the consumer is doing. CAPACITY has to be a power of two
+template<typename T, std::size_t CAPACITY>
+class SpscQueue
+{
+    static_assert(CAPACITY > 0 && (CAPACITY & (CAPACITY - 1)) == 0, "capacity has to be a power of two");
+
+public:
+    // producer only, false if it's full
+    bool push(const T& item)
+    {
+        const std::size_t tail = writeIndex.load(std::memory_order_relaxed);
+        if (tail - readIndex.load(std::memory_order_acquire) == CAPACITY)
+            return false;
+
+        items[tail & (CAPACITY - 1)] = item;
+        writeIndex.store(tail + 1, std::memory_order_release);
+        writeIndex.notify_one(); // only reaches the OS when the consumer is actually waiting
+
+        return true;
+    }
+
+    // consumer only, false if it's empty
+    bool pop(T& out)
+    {
+        const std::size_t head = readIndex.load(std::memory_order_relaxed);
+        if (head == writeIndex.load(std::memory_order_acquire))
+            return false;
+
+        out = items[head & (CAPACITY - 1)];
+        readIndex.store(head + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    // consumer only, sleeps until there's something to pop
+    void wait() const
+    {
+        writeIndex.wait(readIndex.load(std::memory_order_relaxed), std::memory_order_acquire);
+    }
+
+private:
+    T items[CAPACITY];
+
+    // on their own cache lines, so the two threads don't keep taking the line from each other
+    alignas(64) std::atomic<std::size_t> writeIndex{ 0 };
+    alignas(64) std::atomic<std::size_t> readIndex{ 0 };
+};
@@ -0,0 +1,118 @@
+#include "TaskGraph.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+static double millisSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+TaskGraph::TaskId TaskGraph::add(std::string name, Where where, Task func, const std::vector<TaskId>& after)
+{
+    const TaskId id = nodes.size();
+
+    Node& node = nodes.emplace_back();
+    node.name = std::move(name);
+    node.where = where;
+    node.func = std::move(func);
+
+    for (TaskId dependency : after)
+    {
+        if (dependency >= id)
+        {
+            LOG_ERROR("Task %s can't come after task %zu, it doesn't exist yet", node.name.c_str(), dependency);
+            continue;
+        }
+
+        nodes[dependency].dependents.push_back(id);
+        node.waitingOn++;
+    }
+
+    return id;
+}
+
+void TaskGraph::run(ThreadPool* pool)
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    std::mutex mutex;
+    std::condition_variable changed; // a task finished or a main task is ready
+    std::deque<TaskId> mainReady;
+    std::size_t finished = 0;
+
+    std::function<void(TaskId)> schedule;
+
+    auto execute = [&](TaskId id)
+    {
+        Node& node = nodes[id];
+
+        const auto taskStart = std::chrono::steady_clock::now();
+        node.func();
+        node.millis = millisSince(taskStart);
+
+        std::vector<TaskId> nowReady;
+        {
+            std::lock_guard lock(mutex);
+            for (TaskId dependent : node.dependents)
+            {
+                if (--nodes[dependent].waitingOn == 0)
+                    nowReady.push_back(dependent);
+            }
+        }
+
+        for (TaskId ready : nowReady)
+            schedule(ready);
+
+        // counted last and notified under the lock, run() may return the moment it sees the last one
+        std::lock_guard lock(mutex);
+        finished++;
+        changed.notify_all();
+    };
+
+    schedule = [&](TaskId id)
+    {
+        if (pool && nodes[id].where == Where::WORKER)
+        {
+            pool->submit([&execute, id] { execute(id); });
+        }
+        else
+        {
+            std::lock_guard lock(mutex);
+            mainReady.push_back(id);
+        }
+    };
+
+    for (TaskId id = 0; id < nodes.size(); id++)
+    {
+        if (nodes[id].waitingOn == 0)
+            schedule(id);
+    }
+
+    // main tasks run here while the workers get on with theirs
+    std::unique_lock lock(mutex);
+    while (finished < nodes.size())
+    {
+        changed.wait(lock, [&] { return !mainReady.empty() || finished == nodes.size(); });
+
+        if (mainReady.empty())
+            continue;
+
+        const TaskId id = mainReady.front();
+        mainReady.pop_front();
+
+        lock.unlock();
+        execute(id);
+        lock.lock();
+    }
+
+    // logged together at the end rather than as each one finishes, so they read as one block
+    for (const Node& node : nodes)
+    {
+        LOG_INFO("Startup task %s took %.1fms", node.name.c_str(), node.millis);
+    }
+
+    LOG_INFO("Startup tasks took %.1fms altogether", millisSince(start));
+}
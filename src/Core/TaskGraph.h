@@ -0,0 +1,43 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Core.h"
+#include "Core/ThreadPool.h"
+
+// a batch of work with dependencies between tasks, used for startup. Worker tasks go to a ThreadPool,
+// main tasks (anything touching GL or glfw) run on the thread that calls run(). Each task starts as soon
+// as everything it comes after is done, and how long each one took is logged at the end.
+class TaskGraph
+{
+public:
+    typedef std::size_t TaskId;
+
+    enum class Where
+    {
+        MAIN,
+        WORKER
+    };
+
+    // after can only name tasks added before this one, so there can't be any cycles
+    TaskId add(std::string name, Where where, Task func, const std::vector<TaskId>& after = {});
+
+    // runs every task and returns once they're all done. Without a pool everything runs on this thread
+    void run(ThreadPool* pool);
+
+private:
+    struct Node
+    {
+        std::string name;
+        Where where;
+        Task func;
+
+        std::vector<TaskId> dependents;
+        std::size_t waitingOn = 0;
+
+        double millis = 0; // how long func took
+    };
+
+    std::vector<Node> nodes;
+};
@@ -0,0 +1,120 @@
+#include "ThreadPool.h"
+
+// which pool and worker the current thread is, so nested submits stay local
+static thread_local ThreadPool* currentPool = nullptr;
+static thread_local unsigned int currentWorker = 0;
+
+ThreadPool::ThreadPool(unsigned int threadCount)
+{
+    if (threadCount == 0)
+        threadCount = 1; // hardware_concurrency() is allowed to not know
+
+    for (unsigned int i = 0; i < threadCount; i++)
+        workers.emplace_back(std::make_unique<Worker>());
+
+    for (unsigned int i = 0; i < threadCount; i++)
+        threads.emplace_back([this, i] { run(i); });
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard lock(sleepMutex);
+        stopping = true;
+    }
+
+    wake.notify_all();
+
+    for (std::thread& thread : threads)
+        thread.join();
+}
+
+void ThreadPool::submit(Task task)
+{
+    unsigned int index = currentPool == this ? currentWorker : nextWorker++ % workers.size();
+
+    pending++;
+
+    {
+        // counted before it's in a deque so queued never dips below zero, a worker that wakes up
+        // early just tries again. The lock makes sure nobody checks queued and falls asleep in between.
+        std::lock_guard lock(sleepMutex);
+        queued++;
+    }
+
+    {
+        std::lock_guard lock(workers[index]->mutex);
+        workers[index]->tasks.push_back(std::move(task));
+    }
+
+    wake.notify_one();
+}
+
+void ThreadPool::wait()
+{
+    std::unique_lock lock(sleepMutex);
+    idle.wait(lock, [this] { return pending == 0; });
+}
+
+bool ThreadPool::take(unsigned int index, Task& task)
+{
+    // our own newest task first, it's the most likely to still be in cache
+    {
+        Worker& own = *workers[index];
+        std::lock_guard lock(own.mutex);
+
+        if (!own.tasks.empty())
+        {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            return true;
+        }
+    }
+
+    // then the oldest task of whoever has some
+    for (std::size_t i = 1; i < workers.size(); i++)
+    {
+        Worker& victim = *workers[(index + i) % workers.size()];
+        std::lock_guard lock(victim.mutex);
+
+        if (!victim.tasks.empty())
+        {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void ThreadPool::run(unsigned int index)
+{
+    currentPool = this;
+    currentWorker = index;
+
+    while (true)
+    {
+        {
+            std::unique_lock lock(sleepMutex);
+            wake.wait(lock, [this] { return stopping || queued > 0; });
+
+            if (stopping && queued == 0)
+                return;
+        }
+
+        Task task;
+        if (!take(index, task))
+            continue; // someone else got there first
+
+        queued--;
+
+        task();
+
+        if (--pending == 0)
+        {
+            std::lock_guard lock(sleepMutex);
+            idle.notify_all();
+        }
+    }
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Core.h"
+
+typedef std::function<void()> Task;
+
+// fixed set of worker threads, each with its own task deque. Workers take from the back of their own
+// deque and steal from the front of the others' when they run dry, so uneven tasks (one level taking
+// seconds to solve, the next a millisecond) still keep every core busy.
+class ThreadPool
+{
+public:
+    explicit ThreadPool(unsigned int threadCount = std::thread::hardware_concurrency());
+    ~ThreadPool();
+
+    DISALLOW_COPY_AND_ASSIGN(ThreadPool)
+
+    // tasks submitted from a worker go to that worker's own deque
+    void submit(Task task);
+
+    // blocks until every submitted task has finished
+    void wait();
+
+    unsigned int threadCount() const { return unsigned(threads.size()); }
+
+private:
+    struct Worker
+    {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void run(unsigned int index);
+    bool take(unsigned int index, Task& task);
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::thread> threads;
+
+    std::mutex sleepMutex;
+    std::condition_variable wake; // there's work, or we're shutting down
+    std::condition_variable idle; // everything submitted has finished
+
+    std::atomic<std::size_t> queued{ 0 };  // sitting in a deque
+    std::atomic<std::size_t> pending{ 0 }; // submitted and not finished yet
+    std::atomic<unsigned int> nextWorker{ 0 };
+    bool stopping = false;
+};
@@ -13,16 +13,13 @@ void controlClick(UIButton& button, int)
 
     auto clickedControl = (Control)button.text[0]; // beauty of enum classes yay
 
-    // change the keybind
-    if (clickedControl != Control::NONE && !scene->controlBound(clickedControl)) // can't rebind controls!
+    // change the keybind, this also clears the undo history
+    if (clickedControl != Control::NONE && scene->bindControl(Outrospection::get().getEye(), clickedControl)) // can't rebind controls!
     {
-        Outrospection::get().audioManager.play("Control_Select");
-
-        scene->keyBinds.emplace_back(Outrospection::get().getEye(), clickedControl);
+        static const SoundId SELECT = Outrospection::get().audioManager.soundId("Control_Select");
+        Outrospection::get().audioManager.play(SELECT);
 
         button.text[button.text.length() - 1] = char(Outrospection::get().getEye());
-
-        scene->pastPositions.clear(); // clear undo history
     }
 }
 
@@ -68,7 +65,6 @@ void GUIControlsOverlay::draw() const
 void GUIControlsOverlay::setControls(const std::string& controlsStr)
 {
     buttons.clear();
-    ((GUIScene*)Outrospection::get().scene)->keyBinds.clear();
 
     std::vector<std::string> buttonNames;
 
@@ -1,5 +1,9 @@
 #include "GUIOctopusOverlay.h"
+
+#include <array>
+
 #include "Outrospection.h"
+#include "Core/Sequence.h"
 #include "Core/UI/GUIScene.h"
 
 // ugh
@@ -22,14 +26,29 @@ Eye getEye(char c)
     return theEye;
 }
 
+Sequence blink(UIButton& eyeButton)
+{
+    static const AnimationId BLINK = UIComponent::animationId("blink");
+    static const AnimationId DEFAULT = UIComponent::animationId("default");
+
+    eyeButton.setAnimation(BLINK);
+    co_await Sequence::delay(100);
+    eyeButton.setAnimation(DEFAULT);
+}
+
 void eyeClick(UIButton& eyeButton, int mouseButton)
 {
+    static const std::array<SoundId, 3> EYE_POKES = {
+        Outrospection::get().audioManager.soundId("Eye_Poke_0"),
+        Outrospection::get().audioManager.soundId("Eye_Poke_1"),
+        Outrospection::get().audioManager.soundId("Eye_Poke_2")
+    };
+
     // play a random Eye_Poke sound
-    int index = rand() / (RAND_MAX / 3);
-    Outrospection::get().audioManager.play("Eye_Poke_" + std::to_string(index));
+    int index = rand() % 3; // rand() / (RAND_MAX / 3) is 3 when rand() returns RAND_MAX
+    Outrospection::get().audioManager.play(EYE_POKES[index]);
 
-    eyeButton.setAnimation("blink");
-    Util::doLater([&eyeButton]() { eyeButton.setAnimation("default"); }, 100);
+    blink(eyeButton).detach();
 
     // ugh
     Eye pokedEye = getEye(eyeButton.text[8]);
@@ -84,17 +103,19 @@ void undo(UIButton&, int)
 void muteOrUnmute(UIButton& muteButton, int)
 {
     static bool muted = false;
+    static const AnimationId MUTE = UIComponent::animationId("mute");
+    static const AnimationId UNMUTE = UIComponent::animationId("unmute");
 
     if(muted) // unmute
     {
         muted = false;
         Outrospection::get().audioManager.setGlobalVolume(1.0);
-        muteButton.setAnimation("mute");
+        muteButton.setAnimation(MUTE);
     } else
     {
         muted = true;
         Outrospection::get().audioManager.setGlobalVolume(0.0);
-        muteButton.setAnimation("unmute");
+        muteButton.setAnimation(UNMUTE);
     }
 }
 
@@ -1,22 +1,30 @@
 #include "GUIScene.h"
+#include <filesystem>
 #include <json.hpp>
 #include <Core/UI/GUIProgressBar.h>
 
 #include "Outrospection.h"
+#include "Core/FileSystem.h"
 #include "UIButton.h"
 #include "GUIControlsOverlay.h"
 #include "GUIGuide.h"
 
+static glm::vec2 toVec2(const GridPos& pos)
+{
+    return glm::vec2(pos.x, pos.y);
+}
+
 // this is the constructor (ctor for short).
 // it only takes care of copying the level data to store it here for now
-GUIScene::GUIScene() : GUILayer("Scene", false),
+GUIScene::GUIScene(LevelPack& _levels, bool _customLevels) : GUILayer("Scene", false),
                     ghostSprite("ghost", animatedTexture({ "UI/ghost/", "default" }, 16, 2, GL_NEAREST), UITransform(0, 0, 10, 10, {640, 480})),
-                    floor("floor", animatedTexture({ "UI/floor/", "empty" }, 8, 17, GL_NEAREST), UITransform(0, 0, 100, 100, {640, 480})),
-                    ink("hole", GL_NEAREST, UITransform(0, 0, 100, 100, {640, 480})),
+                    background(animatedTexture({"UI/background/", "default"}, 8, 17, GL_NEAREST)),
+                    floor(animatedTexture({ "UI/floor/", "empty" }, 8, 17, GL_NEAREST)),
+                    ink(simpleTexture({"UI/", "hole"}, GL_NEAREST)),
                     flag("flag", animatedTexture({"UI/flag/", "default"}, 16, 2, GL_NEAREST), UITransform(0, 0, 0, 0, {640, 480})),
-                    background("background", animatedTexture({"UI/background/", "default"}, 8, 17, GL_NEAREST), UITransform(0, 0, 10, 10, {640, 480})),
                     playerSprite("player", animatedTexture({ "UI/player/", "default" }, 16, 2, GL_NEAREST), UITransform(0, 0, 10, 10, {640, 480})),
-                    levelProgress("levelProgress", TextureManager::None, UITransform(400, 100, 30, 30, {640, 480}))
+                    levelProgress("levelProgress", TextureManager::None, UITransform(400, 100, 30, 30, {640, 480})),
+                    levels(_levels), customLevels(_customLevels)
 
 {
     handleManually = true;
@@ -29,35 +37,83 @@ GUIScene::GUIScene() : GUILayer("Scene", false),
 
     levelID = Outrospection::loadSave();
 
-    if(Util::fileExists("res/CustomLevels") && !Util::listFiles("res/CustomLevels").empty())
-        levelFiles = Util::listFiles("res/CustomLevels");
-    else
-        levelFiles = Util::listFiles("res/StageData");
+    if(Outrospection::get().isSpeedrun())
+    {
+        std::filesystem::create_directories("replays");
+        replayPath = "replays/speedrun-" + std::to_string(Util::currentTimeMillis()) + ".orep";
 
-    std::sort(levelFiles.begin(), levelFiles.end());
+        recorder.start(true);
+    }
 
     setLevel(levelID);
 }
 
+bool GUIScene::openLevels(LevelPack& pack)
+{
+    std::string error;
+
+    auto tryBundle = [&](const std::string& path)
+    {
+        if(!Util::fileExists(path))
+            return false;
+
+        if(pack.openBundle(path, error))
+            return true;
+
+        LOG_ERROR("Level bundle %s is broken: %s", path.c_str(), error.c_str());
+        return false;
+    };
+
+    if(tryBundle("res/CustomLevels.olb"))
+        return true;
+
+    std::vector<std::string> custom = FileSystem::list("res/CustomLevels");
+    if(!custom.empty())
+    {
+        pack.openFiles(std::move(custom));
+        return true;
+    }
+
+    if(!tryBundle("res/StageData.olb"))
+        pack.openFiles(FileSystem::list("res/StageData"));
+
+    return false;
+}
+
 void GUIScene::setLevel(int lvlID)
 {
-    std::string levelName = levelFiles[lvlID];
+    // whatever was about to happen to the last level doesn't apply to this one
+    winning.reset();
+    dying.reset();
 
-    if(!Util::fileExists(levelName))
+    uint32_t levelHash = 0;
+    std::string error;
+
+    if(!levels.get(lvlID, level, levelHash, error))
     {
-        LOG_ERROR("File %s does not exist! Defaulting to level0...", levelName.c_str());
+        LOG_ERROR("Level %d is broken: %s", lvlID, error.c_str());
 
-        levelID = 0;
-        setLevel(levelID);
-        return;
+        if(lvlID != 0)
+        {
+            LOG_ERROR("Defaulting to level0...");
+
+            levelID = 0;
+            setLevel(levelID);
+            return;
+        }
+
+        // even level0 is broken, give them something they can at least walk around in
+        static const Level fallback = []
+        {
+            Level lvl;
+            std::string ignored;
+            parseLevel(R"level({ "level": ["WWWWWW", "WS  GW", "WWWWWW"], "controls": ")" })level", lvl, ignored);
+            return lvl;
+        }();
+
+        level = fallback;
     }
 
-    // parse level
-    std::string levelData = Util::readAllBytes(levelName);
-    
-    nlohmann::json jason = nlohmann::json::parse(levelData); // this is a joke
-    level = jason.get<Level>();                                 // please laugh
-    
     if(Outrospection::get().isSpeedrun())
     {
         level.controls = "*,()^_<>"; // unlock all controls
@@ -67,14 +123,17 @@ void GUIScene::setLevel(int lvlID)
         level.guideRight = "default";
     }
 
-    playerPosInt = level.start;
+    recorder.level(lvlID, levelHash);
+
+    sim.load(Board::fromLevel(level));
+    buildBoard();
     ghostSprite.visible = false;
     
-    ((GUIProgressBar*)Outrospection::get().progressBarOverlay)->setProgress(float(levelID) / levelFiles.size());
-    levelProgress.text = std::to_string(levelID + 1) + '/' + std::to_string(levelFiles.size());
+    ((GUIProgressBar*)Outrospection::get().progressBarOverlay)->setProgress(float(levelID) / levels.size());
+    levelProgress.text = std::to_string(levelID + 1) + '/' + std::to_string(levels.size());
 
-    if(levelName.starts_with("res/CustomLevels"))
-        Outrospection::get().setWindowText("Level by " + level.author);
+    if(customLevels)
+        Outrospection::get().setWindowText("Level by " + std::string(level.author));
 
     Util::doLater([this]
     {
@@ -84,9 +143,13 @@ void GUIScene::setLevel(int lvlID)
 
 void GUIScene::tick()
 {
-    playerPos = Util::lerp(playerPos, playerPosInt, 0.2);
+    lastPlayerPos = playerPos;
+    lastGhostPos = ghostPos;
+
+    const glm::vec2 playerTarget = toVec2(sim.playerPos());
+    playerPos = Util::lerp(playerPos, playerTarget, 0.2);
 
-    if (!canMove || (canMove && inputQueue.empty() && playerPos != playerPosInt)) // player is not currently moving
+    if (!sim.canMove() || (sim.queuedInputs() == 0 && playerPos != playerTarget)) // player is not currently moving
     {
         if (!ghostInputQueue.empty() && !Outrospection::get().won)
             ghostSprite.visible = true; // ghost is moving
@@ -100,94 +163,102 @@ void GUIScene::tick()
 
     if(!ghostSprite.visible)
     {
-        ghostPosInt = playerPosInt; ghostPos = ghostPosInt;
+        ghostPosInt = sim.playerPos(); ghostPos = toVec2(ghostPosInt);
+        lastGhostPos = ghostPos;
         curGhostMove = -3;
     } else
     {
-        ghostPos = Util::lerp(ghostPos, ghostPosInt, 0.2);
+        ghostPos = Util::lerp(ghostPos, toVec2(ghostPosInt), 0.2);
     }
 
-    floor.tick();
-    ink.tick();
-
     playerSprite.tick();
 
     levelProgress.tick();
 }
 
-void GUIScene::draw() const
+void GUIScene::buildBoard()
 {
-    if (Outrospection::get().won) // don't draw the level if we won
-        return;
-
     int rowLength = level.rowLength;
     int colLength = int(level.data.size() / level.rowLength);
 
     int largestLength = std::max(rowLength, colLength);
+    int width = largestLength + 5; // dirty hack to cover further right with bg tiles
 
-    float spriteScale = 480.f / largestLength; // fill leftmost 480x480 area with actual level
+    // level is centered in a largestLength square, everything else is just background
+    int xOffset = (largestLength - rowLength) / 2;
+    int yOffset = (largestLength - colLength) / 2;
 
-    // adding 1px to prevent lines between sprites when scaled down
-    playerSprite.setScale(spriteScale + 1);
-    ghostSprite.setScale(spriteScale + 1);
-    floor.setScale(spriteScale + 1);
-    ink.setScale(spriteScale + 1);
-    flag.setScale(spriteScale + 1);
-    background.setScale(spriteScale + 1);
+    constexpr uint8_t BACKGROUND = 1 << 0, FLOOR = 1 << 1, INK = 1 << 2;
 
-    for(int x = 0; x < largestLength + 5; x++) // dirty hack to cover further right with bg tiles
+    std::vector<uint8_t> cells(std::size_t(width) * largestLength, BACKGROUND);
+    for (int y = 0; y < colLength; y++)
     {
-        for(int y = 0; y < largestLength; y++)
+        for (int x = 0; x < rowLength; x++)
         {
-            int xSpritePos = x * spriteScale;
-            int ySpritePos = y * spriteScale;
-
-            background.setPosition(xSpritePos, ySpritePos);
-            background.draw();
-
-            if (x < (largestLength - rowLength) / 2 || x >= rowLength + (largestLength - rowLength) / 2 ||
-                y < (largestLength - colLength) / 2 || y >= colLength + (largestLength - colLength) / 2)
-                continue;  // tile not in level
+            uint8_t& cell = cells[(x + xOffset) + (y + yOffset) * width];
 
-            char tile = level.data[(x - (largestLength - rowLength) / 2) + (y - (largestLength - colLength) / 2) * rowLength];
-
-            switch (tile)
+            switch (level.data[x + y * rowLength])
             {
             case ' ': // floor
-                floor.setPosition(xSpritePos, ySpritePos);
-                floor.draw();
+                cell |= FLOOR;
                 break;
 
             case 'W': // wall
                 break;
 
             case 'H': // ink
-                floor.setPosition(xSpritePos, ySpritePos);
-                floor.draw();
-
-                ink.setPosition(xSpritePos, ySpritePos);
-                ink.draw();
+                cell |= FLOOR | INK;
                 break;
             }
         }
     }
 
+    board.setGrid(width, largestLength, cells);
+}
+
+void GUIScene::draw() const
+{
+    if (Outrospection::get().won) // don't draw the level if we won
+        return;
+
+    int rowLength = level.rowLength;
+    int colLength = int(level.data.size() / level.rowLength);
+
+    int largestLength = std::max(rowLength, colLength);
+
+    float spriteScale = 480.f / largestLength; // fill leftmost 480x480 area with actual level
+
+    // adding 1px to prevent lines between sprites when scaled down
+    playerSprite.setScale(spriteScale + 1);
+    ghostSprite.setScale(spriteScale + 1);
+    flag.setScale(spriteScale + 1);
+
+    // the board is in 640x480 units like the sprites, scaled to whatever the framebuffer is
+    const glm::vec2 sizeRatio = glm::vec2(*Outrospection::get().curFbResolution) / glm::vec2(640, 480);
+    const glm::vec2 boardSize = glm::vec2(largestLength + 5, largestLength) * spriteScale;
+
+    board.draw(Outrospection::get().tilemapShader, glm::vec2(0), boardSize * sizeRatio, { &background, &floor, &ink });
+
     int xFlagPos = (level.goal.x + (largestLength - rowLength) / 2) * spriteScale;
     int yFlagPos = (level.goal.y + (largestLength - colLength) / 2) * spriteScale;
 
     flag.setPosition(xFlagPos, yFlagPos);
     flag.draw();
 
-    if (canMove) {
-        float xGhostPos = (ghostPos.x + (largestLength - rowLength) / 2) * spriteScale;
-        float yGhostPos = (ghostPos.y + (largestLength - colLength) / 2) * spriteScale;
+    const float interpolation = Outrospection::get().stepInterpolation();
+
+    if (sim.canMove()) {
+        const glm::vec2 ghostDrawPos = Util::lerp(lastGhostPos, ghostPos, interpolation);
+        float xGhostPos = (ghostDrawPos.x + (largestLength - rowLength) / 2) * spriteScale;
+        float yGhostPos = (ghostDrawPos.y + (largestLength - colLength) / 2) * spriteScale;
 
         ghostSprite.setPosition(xGhostPos, yGhostPos);
         ghostSprite.draw();
     }
 
-    int xPlayerPos = (playerPos.x + (largestLength - rowLength) / 2) * spriteScale;
-    int yPlayerPos = (playerPos.y + (largestLength - colLength) / 2) * spriteScale;
+    const glm::vec2 playerDrawPos = Util::lerp(lastPlayerPos, playerPos, interpolation);
+    int xPlayerPos = (playerDrawPos.x + (largestLength - rowLength) / 2) * spriteScale;
+    int yPlayerPos = (playerDrawPos.y + (largestLength - colLength) / 2) * spriteScale;
 
     playerSprite.setPosition(xPlayerPos, yPlayerPos);
     playerSprite.draw();
@@ -197,15 +268,39 @@ void GUIScene::draw() const
 
 void GUIScene::worldTick()
 {
-    if (!inputQueue.empty())
+    recorder.tick();
+
+    switch (sim.tick())
     {
-        // read input
-        Control curInput = inputQueue[0];
+    case MoveResult::NONE:
+        break;
+
+    case MoveResult::BLOCKED:
+        LOG("Can't move your body."); // Undertale reference!!!!!!
+        break;
+
+    case MoveResult::MOVED:
+    {
+        static const SoundId MOVEMENT = Outrospection::get().audioManager.soundId("Movement");
+        Outrospection::get().audioManager.play(MOVEMENT);
 
-        tryMovePlayer(curInput);
+        ghostPosInt = sim.playerPos();
+        ghostSprite.visible = false;
+        curGhostMove = -3;
+        break;
+    }
 
-        // erase it so we move to the next input
-        inputQueue.erase(inputQueue.begin());
+    case MoveResult::WON:
+        onWin();
+        break;
+
+    case MoveResult::DIED:
+        onDeath(false);
+        break;
+
+    case MoveResult::DIED_INK:
+        onDeath(true);
+        break;
     }
 
     if(curGhostMove >= 0 && !ghostInputQueue.empty())
@@ -213,7 +308,7 @@ void GUIScene::worldTick()
         // read input
         Control curInput = ghostInputQueue[curGhostMove];
 
-        moveGhost(curInput);
+        ghostPosInt = Simulation::applyControl(ghostPosInt, curInput);
     }
 
     // increment so we move to the next input
@@ -225,186 +320,148 @@ void GUIScene::worldTick()
 
     if(curGhostMove == 0) // about to start anim, reset ghost
     {
-        ghostPosInt = playerPosInt;
-        ghostPos = playerPosInt;
+        ghostPosInt = sim.playerPos();
+        ghostPos = toVec2(ghostPosInt);
     }
 }
 
-
-void GUIScene::tryMovePlayer(Control input)
+void GUIScene::onWin()
 {
-    if (!canMove)
-    {
-        LOG("Can't move your body."); // Undertale reference!!!!!!
-        return;
-    }
+    LOG_INFO("You win!! :D");
 
-    auto deltas = controlToDeltas(input);
+    static const SoundId FLAG_GET = Outrospection::get().audioManager.soundId("Flag_Get");
+    Outrospection::get().audioManager.play(FLAG_GET);
 
-    glm::vec2 totalDelta = glm::vec2();
+    flag.visible = false;
+    static const AnimationId WIN = UIComponent::animationId("win");
+    playerSprite.setAnimation(WIN);
+    ((GUIControlsOverlay*)Outrospection::get().controlsOverlay)->roll();
 
-    glm::vec2 ghostPlayerPos = playerPosInt;
+    levelID++;
 
-    for (int i = 0; i < deltas.size(); i++)
-    {
-        glm::vec2& delta = deltas[i];
-
-        ghostPlayerPos += delta;
-
-        if (ghostPlayerPos == level.goal && (i == deltas.size() - 1) && (inputQueue.size() == 1))
-        {
-            playerPosInt = ghostPlayerPos;
-            LOG_INFO("You win!! :D");
+    if(!Outrospection::get().isSpeedrun())
+        Outrospection::writeSave(levelID);
 
-            Outrospection::get().audioManager.play("Flag_Get");
+    if(recorder.recording() && !recorder.save(replayPath))
+        LOG_ERROR("Failed to save replay to %s!", replayPath.c_str());
 
-            flag.visible = false;
-            playerSprite.setAnimation("win");
-            canMove = false;
-            ((GUIControlsOverlay*)Outrospection::get().controlsOverlay)->roll();
+    winning = afterWin();
+}
 
-            levelID++;
+Sequence GUIScene::afterWin()
+{
+    co_await Sequence::delay(1000);
 
-            if(!Outrospection::get().isSpeedrun())
-                Outrospection::writeSave(levelID);
+    if (levelID >= levels.size()) // no more levels
+    {
+        auto& o = Outrospection::get();
+        ((GUIProgressBar*)o.progressBarOverlay)->setProgress(float(levelID) / levels.size());
 
-            Util::doLater([this]
-            {
-                if (levelID >= levelFiles.size()) // no more levels
-                {
-                    auto& o = Outrospection::get();
-                    ((GUIProgressBar*)o.progressBarOverlay)->setProgress(float(levelID) / levelFiles.size());
-
-                    o.won = true;
-                    o.pushOverlay(o.winOverlay);
-                }
-                else
-                {
-                    playerSprite.setAnimation("default");
-
-                    setLevel(this->levelID);
-
-                    LOG_INFO("Advancing to level %i...", this->levelID);
-                }
-            }, 1000);
-            return;
-        }
+        o.won = true;
+        o.pushOverlay(o.winOverlay);
+    }
+    else
+    {
+        static const AnimationId DEFAULT = UIComponent::animationId("default");
+        playerSprite.setAnimation(DEFAULT);
 
-        int intGhostPosition = ghostPlayerPos.x + (ghostPlayerPos.y * level.rowLength);
-        char tile = level.data[intGhostPosition];
+        setLevel(levelID);
 
-        if (tile != ' ' && !((tile == 'H' || tile == 'G') && i == 0 && deltas.size() == 2))
-        {
-            LOG_INFO("Player died!");
-            canMove = false;
-            playerPosInt = ghostPlayerPos;
-
-            if(tile == 'H')
-                playerSprite.setAnimation("failInk");
-            else
-                playerSprite.setAnimation("fail");
-
-            Util::doLater([this] { this->canMove = false; }, 100);
-            Util::doLater([this] {
-                if(!Outrospection::get().isSpeedrun())
-                    this->reset();
-                else {
-                    LOG_INFO("Resetting entire game...");
-                    levelID = 0;
-                    setLevel(levelID);
-                }
-            }, 1500);
+        LOG_INFO("Advancing to level %i...", levelID);
+    }
+}
 
-            return;
-        }
+void GUIScene::onDeath(bool inInk)
+{
+    LOG_INFO("Player died!");
 
-        totalDelta += delta;
-    }
+    static const AnimationId FAIL_INK = UIComponent::animationId("failInk");
+    static const AnimationId FAIL = UIComponent::animationId("fail");
+    playerSprite.setAnimation(inInk ? FAIL_INK : FAIL);
 
-    Outrospection::get().audioManager.play("Movement");
+    if(recorder.recording() && !recorder.save(replayPath))
+        LOG_ERROR("Failed to save replay to %s!", replayPath.c_str());
 
-    playerPosInt += totalDelta;
-    ghostPosInt = playerPosInt;
-    ghostSprite.visible = false;
-    curGhostMove = -3;
+    dying = afterDeath();
 }
 
-void GUIScene::moveGhost(Control input)
+Sequence GUIScene::afterDeath()
 {
-    auto deltas = controlToDeltas(input);
+    co_await Sequence::delay(1500);
 
-    for(auto& delta : deltas)
-        ghostPosInt += delta;
+    if(!Outrospection::get().isSpeedrun())
+        reset();
+    else {
+        LOG_INFO("Resetting entire game...");
+        levelID = 0;
+        setLevel(levelID);
+    }
 }
 
 void GUIScene::tryUndo()
 {
-    if (!canMove || pastPositions.empty())
+    if (!sim.undo())
     {
         LOG("Can't move your body."); // Undertale reference!!!!!!
         return;
     }
 
-    playerPosInt = pastPositions.back();
-    pastPositions.pop_back();
+    recorder.undo();
 
     LOG_INFO("Undid move!");
 }
 
 void GUIScene::reset()
 {
-    playerPosInt = level.start;
-    canMove = true;
-    playerSprite.setAnimation("default");
+    // resetting after dying shouldn't reset a second time later. A pending win is left alone,
+    // the level already counts as beaten and that's what moves on to the next one
+    dying.reset();
+
+    recorder.reset();
+    sim.reset();
+    static const AnimationId DEFAULT = UIComponent::animationId("default");
+    playerSprite.setAnimation(DEFAULT);
     flag.visible = true;
 
     ghostSprite.visible = false;
-    ghostPosInt = playerPosInt; ghostPos = ghostPosInt;
+    ghostPosInt = sim.playerPos(); ghostPos = toVec2(ghostPosInt);
     ghostInputQueue.clear();
 
-    pastPositions.clear();
-    inputQueue.clear();
-
-    ((GUIControlsOverlay*)Outrospection::get().controlsOverlay)->setControls(level.controls);
+    ((GUIControlsOverlay*)Outrospection::get().controlsOverlay)->setControls(std::string(level.controls));
 
-    ((GUIGuide*)Outrospection::get().guideOverlay)->setRightGuide(level.guideRight);
-    ((GUIGuide*)Outrospection::get().guideOverlay)->setLeftGuide(level.guideLeft);
+    ((GUIGuide*)Outrospection::get().guideOverlay)->setRightGuide(std::string(level.guideRight));
+    ((GUIGuide*)Outrospection::get().guideOverlay)->setLeftGuide(std::string(level.guideLeft));
 
     ((GUIControlsOverlay*)Outrospection::get().controlsOverlay)->unroll();
 }
 
-bool GUIScene::controlBound(Control control)
+bool GUIScene::controlBound(Control control) const
 {
-    if (control == Control::NONE)
-        return false; // NONE cannot be bound
+    return sim.controlBound(control);
+}
 
-    for (KeyBinding& bind : keyBinds)
-    {
-        if (bind.m_eye != Eye::NONE && bind.m_control == control)
-            return true; // can't bind control twice!
-    }
+bool GUIScene::bindControl(Eye eye, Control control)
+{
+    if (!sim.bind(eye, control))
+        return false;
 
-    return false;
+    recorder.bind(eye, control);
+    return true;
 }
 
 void GUIScene::doControl(Eye pokedEye)
 {
-    pastPositions.emplace_back(playerPosInt);
-
     Outrospection::get().scheduleWorldTick(); // do tick NOW
 
-    for (KeyBinding& bind : keyBinds)
-    {
-        if (bind.m_eye == pokedEye)
-        {
-            inputQueue.emplace_back(bind.m_control);
-        }
-    }
+    recorder.poke(pokedEye);
+
+    if (!sim.poke(pokedEye))
+        LOG_ERROR("Input queue is full, dropped some inputs!");
 }
 
 void GUIScene::doGhostControl(Eye hoveredEye)
 {
-    for (KeyBinding& bind : keyBinds)
+    for (const KeyBinding& bind : sim.bindings())
     {
         if (bind.m_eye == hoveredEye)
         {
@@ -412,35 +469,3 @@ void GUIScene::doGhostControl(Eye hoveredEye)
         }
     }
 }
-
-std::vector<glm::vec2> GUIScene::controlToDeltas(Control ctrl)
-{
-    std::vector<glm::vec2> deltas;
-    switch (ctrl)
-    {
-    case Control::DASH_UP:
-        deltas.emplace_back(0.0f, -1.0f);
-    case Control::MOVE_UP:
-        deltas.emplace_back(0.0f, -1.0f);
-        break;
-    case Control::DASH_DOWN:
-        deltas.emplace_back(0.0f, 1.0f);
-    case Control::MOVE_DOWN:
-        deltas.emplace_back(0.0f, 1.0f);
-        break;
-    case Control::DASH_RIGHT:
-        deltas.emplace_back(1.0f, 0.0f);
-    case Control::MOVE_RIGHT:
-        deltas.emplace_back(1.0f, 0.0f);
-        break;
-    case Control::DASH_LEFT:
-        deltas.emplace_back(-1.0f, 0.0f);
-    case Control::MOVE_LEFT:
-        deltas.emplace_back(-1.0f, 0.0f);
-        break;
-    default:
-        LOG_ERROR("Unknown control %i", int(ctrl));
-    }
-
-    return deltas;
-}
@@ -1,14 +1,23 @@
 #pragma once
+#include "Core/Sequence.h"
 #include "Core/UI/GUILayer.h"
 #include "Core/UI/UIComponent.h"
+#include "Core/Rendering/Tilemap.h"
+#include "Core/Simulation/Replay.h"
+#include "Core/Simulation/Simulation.h"
 #include "KeyBinding.h"
 
 class GUIScene : public GUILayer
 {
 public:
-    GUIScene();
+    // the levels are opened beforehand (see openLevels), startup does that on a worker thread
+    GUIScene(LevelPack& _levels, bool _customLevels);
     void setLevel(int lvlID);
 
+    // opens the levels in play order, custom levels replace the built-in ones if there are any.
+    // Compiled bundles are used when they exist, loose json files otherwise. Returns true for custom levels.
+    static bool openLevels(LevelPack& pack);
+
     void tick() override;
 
     void draw() const override;
@@ -18,43 +27,58 @@ public:
     void tryUndo();
     void reset();
 
-    bool controlBound(Control control);
+    bool controlBound(Control control) const;
+    bool bindControl(Eye eye, Control control);
     void doControl(Eye pokedEye);
     void doGhostControl(Eye hoveredEye);
 
-    std::vector<KeyBinding> keyBinds{};
-    std::vector<Control> inputQueue;
-
-    Level level{};
-    glm::vec2 playerPosInt{}; // actual position on grid
-    mutable bool canMove = true;
-    mutable std::vector<glm::vec2> pastPositions;
+    LevelView level{};
+    Simulation sim;
 
-    glm::vec2 ghostPosInt{}; // actual position on grid
     int curGhostMove = -1;
     std::vector<Control> ghostInputQueue;
 
     // TODO make this private and control visibility w/ a function
     mutable UIComponent ghostSprite;
 private:
-    void tryMovePlayer(Control input);
-    void moveGhost(Control input);
+    void onWin();
+    void onDeath(bool inInk);
+
+    // what happens a moment after winning or dying, cancelled when the level is reset or changed
+    Sequence afterWin();
+    Sequence afterDeath();
+    Sequence winning;
+    Sequence dying;
+
+    // speedruns get recorded so they can be checked with --verify-replay
+    ReplayRecorder recorder;
+    std::string replayPath;
 
-    static std::vector<glm::vec2> controlToDeltas(Control ctrl);
+    GridPos ghostPosInt{}; // actual position on grid
 
     glm::vec2 playerPos{}; // interpolates player between grid spots
     glm::vec2 ghostPos{};  // interpolates ghost between grid spots
 
+    // where they were a step ago, they're drawn in between (see Outrospection::stepInterpolation)
+    glm::vec2 lastPlayerPos{};
+    glm::vec2 lastGhostPos{};
+
+
+    // the board is drawn as a tilemap, rebuilt when the level changes
+    void buildBoard();
+    Tilemap board;
+
+    SimpleTexture& background;
+    SimpleTexture& floor;
+    SimpleTexture& ink;
 
-    mutable UIComponent floor;
-    mutable UIComponent ink;
     mutable UIComponent flag;
-    mutable UIComponent background;
 
     mutable UIComponent playerSprite;
 
     mutable UIComponent levelProgress;
 
-    std::vector<std::string> levelFiles;
+    LevelPack& levels;
+    bool customLevels = false;
     mutable int levelID = 0;
 };
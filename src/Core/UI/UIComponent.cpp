@@ -63,45 +63,15 @@ void UITransform::setSize(int x, int y)
     size = glm::vec2(x, y);
 }
 
-GLuint UIComponent::quadVAO = 0;
-
 UIComponent::UIComponent(const std::string& _texName, const GLint& texFilter, const UITransform& _transform)
     : UIComponent(_texName, simpleTexture({"UI/", _texName}, texFilter), _transform)
 {
 }
 
 UIComponent::UIComponent(std::string _name, SimpleTexture& _tex, const UITransform& _transform)
-    : text(std::move(_name)), textColor(0.0f), transform(_transform)
+    : text(std::move(_name)), textColor(0.0f), transform(_transform), curAnimation(defaultAnimation())
 {
-    animations.insert(std::make_pair("default", &_tex));
-
-    // we need to create our quad the first time!
-    if (quadVAO == 0)
-    {
-        // configure VAO/VBO
-        GLuint VBO;
-        float vertices[] = {
-            0.0f, 1.0f,
-            1.0f, 0.0f,
-            0.0f, 0.0f,
-
-            0.0f, 1.0f,
-            1.0f, 1.0f,
-            1.0f, 0.0f,
-        };
-
-        glGenVertexArrays(1, &quadVAO);
-        glGenBuffers(1, &VBO);
-
-        glBindBuffer(GL_ARRAY_BUFFER, VBO);
-        glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-
-        glBindVertexArray(quadVAO);
-        glEnableVertexAttribArray(0);
-        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), nullptr);
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glBindVertexArray(0);
-    }
+    addAnimation("default", _tex);
 }
 
 void UIComponent::tick()
@@ -110,24 +80,52 @@ void UIComponent::tick()
 
 void UIComponent::addAnimation(const std::string& anim, SimpleTexture& _tex)
 {
-    animations.insert(std::make_pair(anim, &_tex));
+    const AnimationId id = animationId(anim);
+    if (id.index >= animations.size())
+        animations.resize(id.index + 1, nullptr);
+
+    if (!animations[id.index]) // adding a name twice keeps the first one
+        animations[id.index] = &_tex;
 }
 
 void UIComponent::setAnimation(const std::string& anim)
 {
-    animations.at(curAnimation)->shouldTick = false;
-    animations.at(curAnimation)->reset();
+    setAnimation(animationId(anim));
+}
+
+void UIComponent::setAnimation(AnimationId anim)
+{
+    animations[curAnimation.index]->shouldTick = false;
+    animations[curAnimation.index]->reset();
 
-    if(animations.find(anim) == animations.end())
+    if(anim.index >= animations.size() || !animations[anim.index])
     {
-        LOG_ERROR("Animation %s has not been loaded!", anim.c_str());
-        curAnimation = "default";
+        LOG_ERROR("Animation %s has not been loaded!", anim.valid() ? animationNames().name(anim).c_str() : "(none)");
+        curAnimation = defaultAnimation();
     } else {
         curAnimation = anim;
     }
 
-    animations.at(curAnimation)->reset();
-    animations.at(curAnimation)->shouldTick = true;
+    animations[curAnimation.index]->reset();
+    animations[curAnimation.index]->shouldTick = true;
+}
+
+AnimationId UIComponent::animationId(const std::string& anim)
+{
+    return animationNames().intern(anim);
+}
+
+AnimationId UIComponent::defaultAnimation()
+{
+    static const AnimationId DEFAULT = animationId("default");
+    return DEFAULT;
+}
+
+Interner<AnimationTag>& UIComponent::animationNames()
+{
+    // every component's animations index into the same names, so they all stay short
+    static Interner<AnimationTag> names;
+    return names;
 }
 
 void UIComponent::setPosition(int x, int y)
@@ -150,21 +148,8 @@ void UIComponent::draw(Shader& shader, const Shader& glyphShader) const
     if (!visible)
         return;
 
-    shader.use();
-
-    // TODO maybe we should cache this
-    glm::mat4 model = glm::mat4(1.0f);
-    model = glm::translate(model, glm::vec3(transform.getPos(), 0));
-    model = glm::scale(model, glm::vec3(transform.getSize(), 0));
-
-    shader.setMat4("model", model);
-
-    glActiveTexture(GL_TEXTURE0);
-    animations.at(curAnimation)->bind();
-
-    glBindVertexArray(quadVAO);
-    glDrawArrays(GL_TRIANGLES, 0, 6);
-    glBindVertexArray(0);
+    const SimpleTexture* tex = animations[curAnimation.index];
+    Outrospection::get().spriteBatch.draw(shader, tex->texId, transform.getPos(), transform.getSize(), tex->uvRect);
 
     if (showText && !text.empty()) // TODO make a proper text class
     {
@@ -172,64 +157,72 @@ void UIComponent::draw(Shader& shader, const Shader& glyphShader) const
     }
 }
 
-void UIComponent::drawText(const std::string& text, const Shader& glyphShader) const
+void UIComponent::layoutText(const std::string& text) const
 {
-    glyphShader.use();
-    glyphShader.setVec3("textColor", textColor); // TODO temp set color to black
-    glActiveTexture(GL_TEXTURE0);
-    glBindVertexArray(quadVAO);
-
-    glm::vec2 textScale = transform.getSizeRatio() * 1.5f; // TODO sketchy scale?
+    textLayout.clear();
+    laidOutText = text;
 
-    glm::vec2 textPos = transform.getPos();
-    textPos.y += (transform.getSize().y) / 2 + (10 * textScale.y);
+    // laid out at a size ratio of 1 and scaled when drawn, so resizing the window doesn't need a new layout
+    const float textScale = 1.5f; // TODO sketchy scale?
 
     // add an artificial space at the beginning
-    textPos.x += textScale.x * 10;
+    glm::vec2 textPos = glm::vec2(textScale * 10, 10 * textScale);
 
     for (char c : text)
     {
         if (c <= '\0' || c == ' ')
         {
-            textPos.x += textScale.x * 10;
+            textPos.x += textScale * 10;
             continue;
         }
 
-        if (!Outrospection::get().fontCharacters.contains(c)) {
+        const FontCharacter* fontCharacter = Outrospection::get().fontCharacter(c);
+        if (!fontCharacter) {
             LOG_ERROR("Character %c not found!", c);
 
             // assume a space
-            textPos.x += textScale.x * 10;
+            textPos.x += textScale * 10;
             continue;
         }
 
-        FontCharacter fontCharacter = Outrospection::get().fontCharacters[c];
+        GlyphQuad& quad = textLayout.emplace_back();
+        quad.texId = fontCharacter->textureId;
+        quad.uvRect = fontCharacter->uvRect;
 
-        // calculate model matrix
-        glm::mat4 charModel = glm::mat4(1.0f);
+        quad.pos = textPos;
+        quad.pos.x += fontCharacter->bearing.x * textScale;
+        quad.pos.y -= fontCharacter->bearing.y * textScale;
 
-        glm::vec2 charPos = textPos;
-        charPos.x += fontCharacter.bearing.x * textScale.x;
-        charPos.y -= fontCharacter.bearing.y * textScale.y;
-
-        charModel = glm::translate(charModel, glm::vec3(charPos, 0.0f));
-
-        glm::vec2 charSize = fontCharacter.size * textScale;
-        charModel = glm::scale(charModel, glm::vec3(charSize, 1.0f));
+        quad.size = glm::vec2(fontCharacter->size) * textScale;
 
         // TODO not hardcode this lol
         if (c == '$' || c == '%' || c == '&')
-            glyphShader.setVec3("textColor", glm::vec3(0.0549f, 0.0902f, 0.1725f)); //0x0E172C
+            quad.color = glm::vec3(0.0549f, 0.0902f, 0.1725f); //0x0E172C
         else
-            glyphShader.setVec3("textColor", glm::vec3(0.8941f, 0.2039f, 0.4314f)); //0xE4346E
+            quad.color = glm::vec3(0.8941f, 0.2039f, 0.4314f); //0xE4346E
+
+        textPos.x += (fontCharacter->advance >> 6) * textScale;
+    }
+}
 
-        glyphShader.setMat4("model", charModel);
-        glBindTexture(GL_TEXTURE_2D, fontCharacter.textureId);
+void UIComponent::drawText(const std::string& text, const Shader& glyphShader) const
+{
+    if (text != laidOutText)
+        layoutText(text);
 
-        glDrawArrays(GL_TRIANGLES, 0, 6);
+    SpriteBatch& batch = Outrospection::get().spriteBatch;
 
-        textPos.x += (fontCharacter.advance >> 6) * textScale.x;
-    }
+    const glm::vec2 sizeRatio = transform.getSizeRatio();
+
+    glm::vec2 origin = transform.getPos();
+    origin.y += transform.getSize().y / 2;
 
-    glBindVertexArray(0);
+    // all the glyphs are on one atlas page, so the whole label ends up in a single batch
+    for (const GlyphQuad& quad : textLayout)
+    {
+        if (quad.texId == 0)
+            continue;
+
+        batch.draw(glyphShader, quad.texId, origin + quad.pos * sizeRatio, quad.size * sizeRatio, quad.uvRect, quad.color);
+    }
 }
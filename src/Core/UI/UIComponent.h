@@ -1,14 +1,20 @@
 #pragma once
 #include <string>
+#include <vector>
 
 #include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
 
 #include "Outrospection.h"
+#include "Core/Registry.h"
 #include "Core/Rendering/SimpleTexture.h"
 #include "Core/Rendering/TextureManager.h"
 
 class Shader;
 
+// an animation name, the same for every component that has an animation called that
+typedef Handle<struct AnimationTag> AnimationId;
+
 enum class UIAlign
 {
     CENTER,
@@ -54,7 +60,11 @@ public:
     virtual void tick();
 
     void addAnimation(const std::string& anim, SimpleTexture& _tex);
-    void setAnimation(const std::string& anim);
+    void setAnimation(const std::string& anim); // looks the name up every time, for names that come from data
+    void setAnimation(AnimationId anim);
+
+    // keep the result around (a function-local static does) instead of passing the name each time
+    static AnimationId animationId(const std::string& anim);
 
     void setPosition(int x, int y);
     void setScale(int px);
@@ -74,8 +84,24 @@ protected:
 private:
     virtual void drawText(const std::string& text, const Shader& glyphShader) const;
 
-    std::string curAnimation = "default";
-    std::unordered_map<std::string, SimpleTexture*> animations;
+    // text is only laid out again when it changes, positions are relative to the component at a size ratio of 1
+    struct GlyphQuad
+    {
+        glm::vec2 pos;
+        glm::vec2 size;
+        glm::vec4 uvRect;
+        glm::vec3 color;
+        GLuint texId;
+    };
+
+    void layoutText(const std::string& text) const;
+
+    mutable std::vector<GlyphQuad> textLayout;
+    mutable std::string laidOutText;
+
+    static Interner<AnimationTag>& animationNames();
+    static AnimationId defaultAnimation();
 
-    static GLuint quadVAO;
+    AnimationId curAnimation;
+    std::vector<SimpleTexture*> animations; // indexed by AnimationId, nullptr for the ones this component doesn't have
 };
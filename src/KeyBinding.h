@@ -1,11 +1,12 @@
 #pragma once
-#include "Types.h"
+#include "Core/Simulation/Level.h"
 
 class KeyBinding
 {
 public:
+    KeyBinding() = default;
     KeyBinding(Eye eye, Control control);
 
-    Eye m_eye;
-    Control m_control;
+    Eye m_eye = Eye::NONE;
+    Control m_control = Control::NONE;
 };
@@ -1,5 +1,6 @@
 ﻿#include "Outrospection.h"
 
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 #include <chrono>
@@ -15,6 +16,8 @@
 #include "GLFW/glfw3.h"
 #include "Util.h"
 #include "Core/Layer.h"
+#include "Core/TaskGraph.h"
+#include "Core/Rendering/GLState.h"
 #include "Core/UI/GUIControlsOverlay.h"
 
 #include "Core/UI/GUILayer.h"
@@ -38,43 +41,74 @@ Outrospection::Outrospection(bool speedrun)
         setSpeedrun();
 
     preInit = PreInitialization();
-    audioManager.init({ "Control_Select", "Eye_Poke_0", "Eye_Poke_1", "Eye_Poke_2", "Flag_Get", "Mic_Off", "Mic_On", "Movement", "totallyNotABossBattle", "Waffle_Get" });
 
-    Util::glError();
-    LOG_INFO("AudioManager init DONE!");
+    // the window and font come up before this, as members
+    LOG_INFO("Window and font took %.1fms", std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - launchTime).count());
 
     gameWindow = opengl.gameWindow;
     crtVAO = opengl.crtVAO;
     framebuffers.insert(std::make_pair("default", Framebuffer()));
     framebuffers.insert(std::make_pair("crt", opengl.framebuffer));
 
-    fontCharacters = freetype.loadedCharacters;
+    setFrameRate(FramePacer::Mode::VSYNC);
 
-    registerCallbacks();
-    createShaders();
-    createCursors();
-    createIcon();
-    
-    Util::glError();
-    LOG_INFO("Engine init DONE!");
+    const std::vector<std::string> sounds = { "Control_Select", "Eye_Poke_0", "Eye_Poke_1", "Eye_Poke_2", "Flag_Get", "Mic_Off", "Mic_On", "Movement", "totallyNotABossBattle", "Waffle_Get" };
+    audioManager.addSounds(sounds);
+
+    // clicks and steps can come faster than the sounds finish, those just restart.
+    // The music can't be pushed out by effects
+    using Voices = AudioManager::Voices;
+    for (const char* restart : { "Eye_Poke_0", "Eye_Poke_1", "Eye_Poke_2", "Movement" })
+        audioManager.limitVoices(restart, Voices{ .max = 1, .retrigger = true });
+    audioManager.limitVoices("Control_Select", Voices{ .max = 2, .retrigger = true });
+    audioManager.limitVoices("Flag_Get", Voices{ .max = 1, .priority = 2 });
+    audioManager.limitVoices("totallyNotABossBattle", Voices{ .max = 1, .priority = UINT8_MAX, .retrigger = true });
+
+    // anything that doesn't need GL runs on the workers while the main thread does everything that does.
+    // Textures are only handed out here, they decode on the same workers and show up over the first frames
+    using Where = TaskGraph::Where;
+    TaskGraph startup;
+
+    startup.add("audio device", Where::WORKER, [this] { audioManager.init(); });
+    for (const std::string& sound : sounds)
+        startup.add("sound " + sound, Where::WORKER, [this, sound] { audioManager.loadSound(sound); });
+
+    const auto levelList = startup.add("level list", Where::WORKER, [this] { customLevels = GUIScene::openLevels(levels); });
+    const auto images = startup.add("cursor images", Where::WORKER, [this] { readWindowImages(); });
+
+    startup.add("callbacks", Where::MAIN, [this] { registerCallbacks(); });
+    const auto shaders = startup.add("shaders", Where::MAIN, [this] { createShaders(); });
+    startup.add("cursors", Where::MAIN, [this]
+    {
+        createCursors();
+        createIcon();
 
 #ifdef PLATFORM_WEB
-    emscripten_browser_cursor::set("url('mouse.png'), progress");
+        emscripten_browser_cursor::set("url('mouse.png'), progress");
 #else
-    glfwSetCursor(gameWindow, cursorNone);
+        glfwSetCursor(gameWindow, cursorNone);
 #endif
+    }, { images });
 
-    
-    background = new GUIBackground();
-    progressBarOverlay = new GUIProgressBar();
-    octopusOverlay = new GUIOctopusOverlay();
-    controlsOverlay = new GUIControlsOverlay();
-    guideOverlay = new GUIGuide();
-    winOverlay = new GUIWinOverlay();
-    scene = new GUIScene();
+    startup.add("overlays", Where::MAIN, [this]
+    {
+        background = new GUIBackground();
+        progressBarOverlay = new GUIProgressBar();
+        octopusOverlay = new GUIOctopusOverlay();
+        controlsOverlay = new GUIControlsOverlay();
+        guideOverlay = new GUIGuide();
+        winOverlay = new GUIWinOverlay();
+        scene = new GUIScene(levels, customLevels);
+    }, { levelList, shaders });
+
+#ifdef PLATFORM_WEB
+    startup.run(nullptr);
+#else
+    startup.run(&workers);
+#endif
 
     Util::glError();
-    LOG_INFO("Overlays init DONE!");
+    LOG_INFO("Engine init DONE!");
 
     pushLayer(scene);
     pushOverlay(background);
@@ -83,7 +117,7 @@ Outrospection::Outrospection(bool speedrun)
     pushOverlay(guideOverlay);
     pushOverlay(controlsOverlay);
 
-    audioManager.play("totallyNotABossBattle", 1, true);
+    audioManager.play(audioManager.soundId("totallyNotABossBattle"), 1, true);
 
 #ifndef __EMSCRIPTEN__
     // for good measure, redo UI here
@@ -136,8 +170,8 @@ void Outrospection::run()
 
     running = true;
 
-    lastFrame = Util::currentTimeMillis(); // I miss java
-    deltaTime = 1.0f / 60.0f;
+    frameStart = std::chrono::steady_clock::now();
+    framePacer.restart(); // startup isn't a slow frame
 
 #ifdef __EMSCRIPTEN__
     emscripten_set_main_loop_arg(&LoopCallback, this, 0, true);
@@ -249,7 +283,7 @@ Eye Outrospection::getEye() const
 
 void Outrospection::scheduleWorldTick()
 {
-    lastTick = Util::currentTimeMillis() - 5000;
+    stepsToWorldTick = 0;
 }
 
 void Outrospection::toggleFullscreen()
@@ -279,50 +313,60 @@ void Outrospection::toggleFullscreen()
     }
 
     isFullscreen = !isFullscreen;
+
+    // might be a different refresh rate now
+    if (framePacer.getMode() == FramePacer::Mode::VSYNC)
+        setFrameRate(FramePacer::Mode::VSYNC);
+}
+
+void Outrospection::setFrameRate(FramePacer::Mode mode, int hz)
+{
+#ifndef PLATFORM_WEB
+    // with vsync the swap does the waiting, the pacer would only make frames late
+    glfwSwapInterval(mode == FramePacer::Mode::VSYNC ? 1 : 0);
+
+    if (mode == FramePacer::Mode::VSYNC)
+    {
+        GLFWmonitor* monitor = glfwGetWindowMonitor(gameWindow);
+        hz = glfwGetVideoMode(monitor ? monitor : glfwGetPrimaryMonitor())->refreshRate;
+    }
+
+    framePacer.setMode(mode, hz);
+#endif
 }
 
 void Outrospection::runGameLoop()
 {
-    currentTimeMillis = Util::currentTimeMillis();
-    deltaTime = float(currentTimeMillis - lastFrame) / 1000.0f;
-    lastFrame = currentTimeMillis;
+    const auto now = std::chrono::steady_clock::now();
+    unsteppedTime += std::min<std::chrono::steady_clock::duration>(now - frameStart, MAX_FRAME_TIME);
+    frameStart = now;
 
     // Update game world
     {
         // fetch input into simplified controller class
         updateInput();
 
-        if (!isGamePaused)
+        // as many steps as fit in the time since the last frame, the rest carries over
+        while (unsteppedTime >= STEP)
         {
-            // Run one "tick" of the game physics
-            runTick();
-            textureManager.tickAllTextures();
-
-            // execute scheduled tasks
-            for(int i = 0; i < futureFunctions.size(); i++)
-            {
-                const auto& futureFunc = futureFunctions[i];
-                
-                if(currentTimeMillis - futureFunc.startTime > futureFunc.waitTime)
-                {
-                    futureFunc.func();
-
-                    // pop the function
-                    futureFunctions.erase(futureFunctions.begin() + i);
-                    i--;
-                }
-            }
-        }
-        
-        // UIs are also updated when game is paused
-        for (auto& layer : layerStack)
-        {
-            layer->tick();
+            unsteppedTime -= STEP;
+            step();
         }
+
+        // drawn this far from the second to last step towards the last one
+        interpolation = std::chrono::duration<float>(unsteppedTime) / std::chrono::duration<float>(STEP);
+
+        // execute scheduled tasks
+        if (!isGamePaused)
+            scheduler.run();
     }
 
     // Draw the frame!
     {
+        // anything that finished decoding goes up first, so it shows this frame
+        textureManager.uploadPending();
+        audioManager.update();
+
         glDisable(GL_DEPTH_TEST); // disable depth test so stuff near camera isn't clipped
         
         framebuffers["crt"].bind();
@@ -338,7 +382,7 @@ void Outrospection::runGameLoop()
         // draw CRT with shader effect
         crtShader.use();
         
-        glBindVertexArray(crtVAO);
+        GLState::bindVertexArray(crtVAO);
         framebuffers["crt"].bindTexture();
         glDrawArrays(GL_TRIANGLES, 0, 6);
 
@@ -351,6 +395,9 @@ void Outrospection::runGameLoop()
             
             layer->draw();
         }
+
+        spriteBatch.flush();
+        GLState::endFrame();
     }
 
     // check for errors
@@ -361,31 +408,45 @@ void Outrospection::runGameLoop()
     glfwSwapBuffers(gameWindow);
     glfwPollEvents();
 
+    if (!drewFirstFrame)
+    {
+        drewFirstFrame = true;
+        LOG_INFO("First frame after %.1fms", std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - launchTime).count());
+    }
+
 
 
     if (glfwWindowShouldClose(gameWindow))
         running = false;
 
-    currentTimeMillis = Util::currentTimeMillis();
-    time_t frameTime = currentTimeMillis - lastFrame;
-
-    // sleep for any extra time we have
-    auto extraTime = 16 - frameTime;
-    //LOG("%i", extraTime);
+#ifndef PLATFORM_WEB
+    // the browser already calls us once per display frame
+    framePacer.endFrame();
+#endif
+}
 
-    if(extraTime > 0) {
-        auto m = std::chrono::milliseconds(extraTime - 1);
-        std::this_thread::sleep_for(m);
+void Outrospection::step()
+{
+    if (!isGamePaused)
+    {
+        // Run one "tick" of the game physics
+        runTick();
+        textureManager.tickAllTextures();
     }
 
+    // UIs are also updated when game is paused
+    for (auto& layer : layerStack)
+    {
+        layer->tick();
+    }
 }
 
 void Outrospection::runTick()
 {
-    if (currentTimeMillis - lastTick < 200) // five ticks per second
+    if (--stepsToWorldTick > 0)
         return;
-    
-    lastTick = currentTimeMillis;
+
+    stepsToWorldTick = STEPS_PER_WORLD_TICK;
 
     ((GUIScene*)scene)->worldTick();
 }
@@ -488,50 +549,54 @@ void Outrospection::createShaders()
 {
     LOG_INFO("Setting up shaders...");
 
-    screenShader = Shader("screen", "screen");
-    crtShader    = Shader("crt"   , "crt"   );
-    spriteShader = Shader("sprite", "sprite");
-    inkShader    = Shader("sprite", "ink"   );
-    glyphShader  = Shader("sprite", "glyph" );
+    screenShader  = Shader("screen", "screen" );
+    crtShader     = Shader("crt"   , "crt"    );
+    spriteShader  = Shader("sprite", "sprite" );
+    inkShader     = Shader("sprite", "ink"    );
+    glyphShader   = Shader("sprite", "glyph"  );
+    tilemapShader = Shader("sprite", "tilemap");
 }
 
-void Outrospection::createCursors()
-{
-    GLFWimage cursorImage;
-    int width = 10, height = 10;
-
-    unsigned char* data = TextureManager::readImageBytes("res/ObjectData/Textures/mouse.png", width, height);
-    cursorImage.pixels = data; cursorImage.width = width; cursorImage.height = height;
-    cursorNone = glfwCreateCursor(&cursorImage, 0, 0);
-    TextureManager::free(data);
+// same order as windowImages, the cursors for each Eye and then the icon
+static constexpr const char* WINDOW_IMAGE_PATHS[] = {
+    "res/ObjectData/Textures/mouse.png",
+    "res/ObjectData/Textures/circleMouse.png",
+    "res/ObjectData/Textures/squareMouse.png",
+    "res/ObjectData/Textures/triangleMouse.png",
+    "res/ObjectData/icon.png"
+};
 
-    data = TextureManager::readImageBytes("res/ObjectData/Textures/circleMouse.png", width, height);
-    cursorImage.pixels = data; cursorImage.width = width; cursorImage.height = height;
-    cursorCircle = glfwCreateCursor(&cursorImage, 0, 0);
-    TextureManager::free(data);
-
-    data = TextureManager::readImageBytes("res/ObjectData/Textures/squareMouse.png", width, height);
-    cursorImage.pixels = data; cursorImage.width = width; cursorImage.height = height;
-    cursorSquare = glfwCreateCursor(&cursorImage, 0, 0);
-    TextureManager::free(data);
+void Outrospection::readWindowImages()
+{
+    static_assert(std::size(WINDOW_IMAGE_PATHS) == std::tuple_size_v<decltype(windowImages)>);
 
-    data = TextureManager::readImageBytes("res/ObjectData/Textures/triangleMouse.png", width, height);
-    cursorImage.pixels = data; cursorImage.width = width; cursorImage.height = height;
-    cursorTriangle = glfwCreateCursor(&cursorImage, 0, 0);
-    TextureManager::free(data);
+    for (std::size_t i = 0; i < windowImages.size(); i++)
+    {
+        GLFWimage& image = windowImages[i];
+        image.pixels = TextureManager::readImageBytes(WINDOW_IMAGE_PATHS[i], image.width, image.height);
+    }
 }
 
-void Outrospection::createIcon() const
+void Outrospection::createCursors()
 {
-    GLFWimage image;
-    int width = 10, height = 10;
+    cursorNone = glfwCreateCursor(&windowImages[0], 0, 0);
+    cursorCircle = glfwCreateCursor(&windowImages[1], 0, 0);
+    cursorSquare = glfwCreateCursor(&windowImages[2], 0, 0);
+    cursorTriangle = glfwCreateCursor(&windowImages[3], 0, 0);
 
-    unsigned char* data = TextureManager::readImageBytes("res/ObjectData/icon.png", width, height);
-    image.pixels = data; image.width = width; image.height = height;
+    for (std::size_t i = 0; i < 4; i++)
+    {
+        TextureManager::free(windowImages[i].pixels);
+        windowImages[i].pixels = nullptr;
+    }
+}
 
-    glfwSetWindowIcon(gameWindow, 1, &image);
+void Outrospection::createIcon()
+{
+    glfwSetWindowIcon(gameWindow, 1, &windowImages[4]);
 
-    TextureManager::free(data);
+    TextureManager::free(windowImages[4].pixels);
+    windowImages[4].pixels = nullptr;
 }
 
 void Outrospection::setResolution(glm::vec2 res)
@@ -609,6 +674,12 @@ void Outrospection::key_callback(GLFWwindow* window, int key, int scancode, int
         case GLFW_KEY_F11:
             Outrospection::get().toggleFullscreen();
             break;
+        case GLFW_KEY_F3:
+        {
+            const GLState::Counters& counters = GLState::lastFrame();
+            LOG_INFO("GL state changes last frame: %i issued, %i skipped", counters.issued, counters.skipped);
+            break;
+        }
         }
     }
 }
@@ -2,6 +2,9 @@
 
 #include "Core.h"
 
+#include <array>
+#include <chrono>
+
 #include <glm/vec2.hpp>
 
 #include "Types.h"
@@ -13,12 +16,18 @@
 #include "Core/LayerStack.h"
 #include "Core/PreInitialization.h"
 #include "Core/Registry.h"
+#include "Core/Scheduler.h"
+#include "Core/ThreadPool.h"
 #include "Core/AudioManager.h"
+#include "Core/FramePacer.h"
 #include "Core/Rendering/FreeType.h"
 #include "Core/Rendering/Framebuffer.h"
 #include "Core/Rendering/OpenGL.h"
 #include "Core/Rendering/Shader.h"
+#include "Core/Rendering/SpriteBatch.h"
+#include "Core/Rendering/UniformBuffer.h"
 #include "Core/Rendering/TextureManager.h"
+#include "Core/Simulation/LevelPack.h"
 #include "Core/UI/GUILayer.h"
 
 
@@ -29,6 +38,9 @@ class Layer;
 
 class Outrospection
 {
+    // taken before anything else starts up, for timing startup
+    const std::chrono::steady_clock::time_point launchTime = std::chrono::steady_clock::now();
+
     PreInitialization preInit;
 
     OpenGL opengl; // defined at the beginning so nothing gets initialized before this
@@ -68,6 +80,9 @@ public:
 
     void toggleFullscreen();
 
+    // vsync by default, see FramePacer. hz is only used for FIXED
+    void setFrameRate(FramePacer::Mode mode, int hz = 0);
+
     void setResolution(glm::vec2 res);
     void updateResolution(int x, int y);
     glm::vec2 getWindowResolution() const;
@@ -78,17 +93,27 @@ public:
 
     glm::vec2 lastMousePos = glm::vec2(curWindowResolution / 2);
 
+#ifndef PLATFORM_WEB
+    ThreadPool workers; // startup tasks and texture decoding, see TaskGraph and TextureManager
+#endif
+
     TextureManager textureManager;
+    SpriteBatch spriteBatch;
     AudioManager audioManager;
 
-	std::vector<Util::FutureRun> futureFunctions;
-    std::unordered_map<char, FontCharacter> fontCharacters;
+    Scheduler scheduler; // see Util::doLater
+    const FontCharacter* fontCharacter(char c) { return freetype.getCharacter(c); }
     
     Shader screenShader;
     Shader crtShader;
     Shader spriteShader;
     Shader inkShader;
     Shader glyphShader;
+    Shader tilemapShader;
+
+#ifndef PLATFORM_WEB
+    UniformBuffer<ViewportUniforms> viewportUniforms{UniformBlock::VIEWPORT};
+#endif
 
     GUILayer* scene;
     GUILayer* background;
@@ -100,13 +125,16 @@ public:
 
     bool won = false;
 
-    time_t currentTimeMillis = 0;
+    // how far between the last two simulation steps this frame is, 0 to 1. Draw anything that moves per tick() there
+    float stepInterpolation() const { return interpolation; }
 	
     DISALLOW_COPY_AND_ASSIGN(Outrospection)
 private:
     void runGameLoop();
+
+    // one fixed step of everything that ticks
+    void step();
     void runTick();
-    time_t lastTick = 0;
 
     // set to false when the game loop shouldn't run
     bool running = false;
@@ -114,9 +142,19 @@ private:
     // this being on makes it less "true to the game" but allows for cooler strats so I'm keeping it
     bool speedrunMode = false;
 
-    // timing
-    float deltaTime = 0; // Time between current frame and last frame
-    time_t lastFrame = 0; // Time of last frame
+    // timing. Everything that ticks does so at a fixed rate, however fast frames are drawn,
+    // so the game plays the same at 30 or 240 fps
+    static constexpr std::chrono::steady_clock::duration STEP = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / 60.0));
+    static constexpr int STEPS_PER_WORLD_TICK = 12; // five world ticks per second
+
+    // a frame longer than this (a breakpoint, dragging the window) is only caught up on this much
+    static constexpr std::chrono::milliseconds MAX_FRAME_TIME{ 250 };
+
+    std::chrono::steady_clock::time_point frameStart;
+    FramePacer framePacer;
+    std::chrono::steady_clock::duration unsteppedTime{ 0 }; // carried over to the next frame's steps
+    float interpolation = 1;
+    int stepsToWorldTick = 0;
 
     GLFWwindow* gameWindow;
     bool isFullscreen = false;
@@ -137,8 +175,18 @@ private:
 	
     void registerCallbacks() const;
     void createShaders();
+
+    // the cursor and icon pixels are decoded on a worker, glfw has to make them on the main thread
+    std::array<GLFWimage, 5> windowImages{};
+    void readWindowImages();
     void createCursors();
-    void createIcon() const;
+    void createIcon();
+
+    // opened on a worker during startup, GUIScene plays them
+    LevelPack levels;
+    bool customLevels = false;
+
+    bool drewFirstFrame = false;
 	
     Eye eye = Eye::NONE;
     GLFWcursor *cursorNone{}, *cursorCircle{}, *cursorSquare{}, *cursorTriangle{};
@@ -1,4 +1,47 @@
+#include <fstream>
+#include <sstream>
+
 #include "Outrospection.h"
+#include "Core/FileSystem.h"
+#include "Core/Simulation/Replay.h"
+#include "Core/UI/GUIScene.h"
+
+// plays a recorded speedrun without opening a window and prints how far it got
+static int verifyReplay(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    std::stringstream data;
+    data << file.rdbuf();
+
+    Replay replay;
+    std::string error;
+
+    if(!file || !Replay::read(data.str(), replay, error))
+    {
+        std::cout << "Can't read replay " << path << ": " << (file ? error : "can't open file") << std::endl;
+        return -1;
+    }
+
+    LevelPack levels;
+    GUIScene::openLevels(levels);
+    ReplayResult result = playReplay(replay, levels);
+
+    std::cout << "replay:   " << path << (replay.flags & Replay::FLAG_SPEEDRUN ? " (speedrun)" : "") << "\n"
+              << "levels:   " << result.startLevel << " to " << result.lastLevel << " of " << levels.size()
+              << ", " << result.levelsBeaten << " beaten, " << result.deaths << " deaths\n"
+              << "ticks:    " << result.ticks << "\n";
+
+    if(!result.valid)
+    {
+        std::cout << "invalid:  " << result.error << std::endl;
+        return 1;
+    }
+
+    std::cout << "time:     " << result.ms / 1000.0 << " s\n"
+              << "finished: " << (result.finished ? "yes" : "no") << std::endl;
+
+    return 0;
+}
 
 // ugly Windows code so that we don't open a cmd window along the program, but can still see output if we start from cmd
 #ifdef PLATFORM_WINDOWS
@@ -24,6 +67,14 @@ int main(int argc, char** argv) {
 #endif
 
 
+    // release builds ship everything in one pak, loose files in res still win over it
+    if(Util::fileExists("res.pak"))
+    {
+        std::string error;
+        if(!FileSystem::mount("res.pak", "res", error))
+            LOG_ERROR("Can't use res.pak, reading loose files instead: %s", error.c_str());
+    }
+
     // check if we can read the filesystem
     bool canReadFiles = Util::fileExists("res/ShaderData/crt.vert");
     if(!canReadFiles)
@@ -47,20 +98,34 @@ int main(int argc, char** argv) {
     }
 
     bool speedrun = false;
+    bool setFrameRate = false;
+    FramePacer::Mode frameRateMode = FramePacer::Mode::VSYNC;
+    int frameRate = 0;
 
-    if(argc >= 2)
+    for(int i = 1; i < argc; i++)
     {
-        if(strcmp(argv[1], "--speedrun") == 0)
+        if(strcmp(argv[i], "--speedrun") == 0)
         {
             speedrun = true;
+        } else if(strcmp(argv[i], "--verify-replay") == 0 && i + 1 < argc)
+        {
+            return verifyReplay(argv[i + 1]);
+        } else if(strcmp(argv[i], "--fps") == 0 && i + 1 < argc && FramePacer::parse(argv[i + 1], frameRateMode, frameRate))
+        {
+            setFrameRate = true;
+            i++;
         } else {
-            std::cout << "Unknown argument \"" << argv[1] << "\"! Options are:\n"
-                      << "--speedrun" << std::endl;
+            std::cout << "Unknown argument \"" << argv[i] << "\"! Options are:\n"
+                      << "--speedrun\n"
+                      << "--verify-replay <file>\n"
+                      << "--fps <vsync|uncapped|frames per second>" << std::endl;
             return -1;
         }
     }
 
     auto outrospection = Outrospection(speedrun);
+    if(setFrameRate)
+        outrospection.setFrameRate(frameRateMode, frameRate);
 
     // run the game!
     outrospection.run();
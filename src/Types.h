@@ -5,65 +5,10 @@
 #include <glm/gtc/quaternion.hpp>
 #include <glm/gtx/quaternion.hpp>
 
+#include "Core/Simulation/Level.h"
 #include "Core/Rendering/Resource.h"
 #include "Core/Rendering/SimpleTexture.h"
 
-struct Level
-{
-    std::string data;
-    int rowLength;
-    std::string controls;
-
-    glm::vec2 start;
-    glm::vec2 goal;
-
-    std::string guideRight;
-    std::string guideLeft;
-
-    std::string author;
-};
-
-inline void from_json(const nlohmann::json& j, Level& lvl)
-{
-    auto rows = j["level"].get<std::vector<std::string>>();
-    lvl.rowLength = rows[0].size();
-    lvl.data = std::accumulate(begin(rows), end(rows), std::string());
-
-    j["controls"].get_to(lvl.controls);
-
-    lvl.guideLeft = j.value("guideLeft", "default");
-    lvl.guideRight = j.value("guideRight", "default");
-
-    int startIndex = lvl.data.find('S'); lvl.data[startIndex] = ' ';
-    lvl.start = glm::vec2(startIndex % lvl.rowLength, int(startIndex / lvl.rowLength));
-
-    int goalIndex = lvl.data.find('G'); lvl.data[goalIndex] = ' ';
-    lvl.goal = glm::vec2(goalIndex % lvl.rowLength, int(goalIndex / lvl.rowLength));
-
-    lvl.author = j.value("author", "Anonymous");
-}
-
-enum class Control
-{
-    NONE = ' ',
-    MOVE_UP = '*',
-    MOVE_DOWN = ',',
-    MOVE_LEFT = '(',
-    MOVE_RIGHT = ')',
-    DASH_UP = '^',
-    DASH_DOWN = '_',
-    DASH_LEFT = '<',
-    DASH_RIGHT = '>'
-};
-
-enum class Eye
-{
-    NONE = ' ',
-    CIRCLE = '$',
-    SQUARE = '%',
-    TRIANGLE = '&'
-};
-
 struct Transform
 {
     Transform(const glm::vec3& position = glm::vec3(1.0), const glm::vec3& scale = glm::vec3(1.0), const glm::quat& rotation = glm::quat())
@@ -267,7 +212,8 @@ struct Collision
 
 struct FontCharacter
 {
-    GLuint textureId;
+    GLuint textureId; // glyph atlas page, 0 for glyphs with nothing to draw like space
+    glm::vec4 uvRect; // where the glyph is on its page
     glm::ivec2 size;
     glm::ivec2 bearing; // offset from base line
     long advance; // offset to advance to next glyph
@@ -282,11 +228,4 @@ public:
     {
         return st.texId;
     }
-
-    size_t operator()(const Resource& r) const
-    {
-        const std::hash<std::string> strhash;
-
-        return strhash(r.fullPath);
-    }
 };
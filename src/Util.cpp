@@ -20,6 +20,7 @@
 #include "Types.h"
 #include "Constants.h"
 #include "Outrospection.h"
+#include "Core/FileSystem.h"
 
 glm::vec3 operator*(const int& lhs, const glm::vec3& vec)
 {
@@ -114,26 +115,14 @@ time_t Util::currentTimeMillis()
     return std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count();
 }
 
-Util::FutureRun::FutureRun(std::function<void()> _func, time_t _startTime, time_t _waitTime)
-    : func(_func), startTime(_startTime), waitTime(_waitTime)
-{ }
-
-void Util::doLater(std::function<void()> func, time_t waitTime)
+TimerId Util::doLater(SmallTask func, time_t waitTime)
 {
-    Outrospection::get().futureFunctions.emplace_back(func, currentTimeMillis(), waitTime);
+    return Outrospection::get().scheduler.schedule(std::move(func), std::chrono::milliseconds(waitTime));
 }
 
 bool Util::fileExists(const std::string& file)
 {
-    std::string fullPath(file);
-
-    LOG("Checking file %s", fullPath.c_str());
-
-#ifndef PLATFORM_XP
-    return std::filesystem::exists(fullPath);
-#else
-    return PathFileExistsA(fullPath.c_str());
-#endif
+    return FileSystem::exists(file);
 }
 
 std::vector<std::string> Util::listFiles(const std::string& dir)
@@ -183,33 +172,15 @@ std::vector<std::string> Util::listFiles(const std::string& dir)
 
 std::string Util::readAllBytes(const std::string& file)
 {
-    std::string fullPath(file);
-    
-    std::ifstream fileStream;
-
-    // ensure ifstream objects can throw exceptions
-    fileStream.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+    FileData data;
 
-    try
+    if (!FileSystem::read(file, data))
     {
-        // open file
-        fileStream.open(fullPath);
-        std::stringstream fileString;
-
-        // read file's buffer contents into streams
-        fileString << fileStream.rdbuf();
-
-        // close file handlers
-        fileStream.close();
-
-        // convert stream into string
-        return fileString.str();
-    }
-    catch (std::ifstream::failure& e)
-    {
-        LOG_ERROR("Failed to read file \"%s\"! errno %s", fullPath.c_str(), e.what());
+        LOG_ERROR("Failed to read file \"%s\"!", file.c_str());
         return "ERROR: NO FILE";
     }
+
+    return std::string(data.text());
 }
 
 glm::vec3 Util::rotToVec3(const float yaw, const float pitch)
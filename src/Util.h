@@ -4,6 +4,7 @@
 #include <glm/glm.hpp>
 
 #include "Types.h"
+#include "Core/Scheduler.h"
 
 glm::vec3 operator*(const int& lhs, const glm::vec3& vec);
 glm::vec2 operator*(int i, const glm::vec2& vec);
@@ -78,22 +79,13 @@ namespace Util
     // I miss Java
     time_t currentTimeMillis();
 
-	// future stuff
-    struct FutureRun
-    {
-        FutureRun(std::function<void()> _func, time_t _startTime, time_t _waitTime);
-
-        std::function<void()> func;
-        time_t startTime;
-
-        time_t waitTime;
-    };
-
-    void doLater(std::function<void()> func, time_t waitTime);
+	// future stuff, runs func on the main thread in waitTime millis unless it's cancelled with Outrospection's scheduler
+    TimerId doLater(SmallTask func, time_t waitTime);
     
     constexpr std::size_t hashBytes(const char* data, std::size_t length)
     {
-#define get16bits(d) ((((uint32_t)(((const uint8_t *)(d))[1])) << 8) +(uint32_t)(((const uint8_t *)(d))[0]))
+// no pointer casts in here, those can't run at compile time
+#define get16bits(d) ((uint32_t(uint8_t((d)[1])) << 8) + uint32_t(uint8_t((d)[0])))
 
         auto hash = uint32_t(length);
 
@@ -140,10 +132,12 @@ namespace Util
         return hash;
     }
 
+    // these two go through the FileSystem, so they see what's in the pak too
     bool fileExists(const std::string& file);
-    std::vector<std::string> listFiles(const std::string& dir);
     std::string readAllBytes(const std::string& file);
 
+    std::vector<std::string> listFiles(const std::string& dir);
+
     glm::vec3 rotToVec3(float yaw, float pitch = 0);
 
     std::string vecToStr(const glm::vec3& vec);
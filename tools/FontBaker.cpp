@@ -0,0 +1,80 @@
+// Rasterises the game's glyphs onto one atlas page ahead of time, so the game can skip FreeType at startup.
+// Usage: OctopuzzlerFontBaker <font> <output.ofa>
+
+#include <algorithm>
+#include <iostream>
+
+#include <ft2build.h>
+#include FT_FREETYPE_H
+
+#include "Core/Rendering/BakedFont.h"
+
+int main(int argc, char** argv)
+{
+    if (argc != 3)
+    {
+        std::cout << "Usage: " << argv[0] << " <font> <output.ofa>" << std::endl;
+        return 2;
+    }
+
+    FT_Library ft;
+    if (FT_Init_FreeType(&ft))
+    {
+        std::cout << "Failed to initialize FreeType" << std::endl;
+        return 1;
+    }
+
+    FT_Face face;
+    if (FT_New_Face(ft, argv[1], 0, &face))
+    {
+        std::cout << "Can't load " << argv[1] << std::endl;
+        return 1;
+    }
+
+    FT_Set_Pixel_Sizes(face, 0, BakedFont::PIXEL_SIZE);
+
+    std::vector<BakedFont::Source> sources;
+
+    for (char c : BakedFont::GLYPHS)
+    {
+        if (FT_Load_Char(face, (unsigned char)c, FT_LOAD_RENDER))
+        {
+            std::cout << "Failed to load glyph '" << c << "'" << std::endl;
+            return 1;
+        }
+
+        const FT_GlyphSlot glyph = face->glyph;
+        const FT_Bitmap& bitmap = glyph->bitmap;
+
+        BakedFont::Source& source = sources.emplace_back();
+        source.code = (unsigned char)c;
+        source.width = int(bitmap.width);
+        source.height = int(bitmap.rows);
+        source.bearingX = glyph->bitmap_left;
+        source.bearingY = glyph->bitmap_top;
+        source.advance = int(glyph->advance.x);
+
+        // rows can be padded, copy them one at a time
+        source.bitmap.resize(std::size_t(source.width) * source.height);
+        for (int y = 0; y < source.height; y++)
+        {
+            std::copy_n(bitmap.buffer + std::ptrdiff_t(y) * bitmap.pitch, source.width,
+                        source.bitmap.begin() + std::ptrdiff_t(y) * source.width);
+        }
+    }
+
+    FT_Done_Face(face);
+    FT_Done_FreeType(ft);
+
+    const std::size_t glyphCount = sources.size();
+
+    std::string error;
+    if (!BakedFont::write(argv[2], std::move(sources), error))
+    {
+        std::cout << error << std::endl;
+        return 1;
+    }
+
+    std::cout << "Baked " << glyphCount << " glyphs into " << argv[2] << std::endl;
+    return 0;
+}
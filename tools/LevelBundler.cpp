@@ -0,0 +1,67 @@
+// Compiles every level in a directory into one bundle the game can map and read without parsing anything.
+// Levels go in the same order the game plays loose files in, broken levels fail the build.
+// Usage: OctopuzzlerBundler <level directory> <output.olb>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include "Core/Simulation/LevelBundle.h"
+
+int main(int argc, char** argv)
+{
+    if (argc != 3)
+    {
+        std::cout << "Usage: " << argv[0] << " <level directory> <output.olb>" << std::endl;
+        return 2;
+    }
+
+    std::vector<std::filesystem::path> files;
+
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(argv[1], ec))
+    {
+        if (entry.is_regular_file())
+            files.push_back(entry.path());
+    }
+
+    if (ec)
+    {
+        std::cout << "Can't read " << argv[1] << ": " << ec.message() << std::endl;
+        return 2;
+    }
+
+    std::sort(files.begin(), files.end());
+
+    std::vector<LevelBundle::Source> sources(files.size());
+
+    for (std::size_t i = 0; i < files.size(); i++)
+    {
+        LevelBundle::Source& source = sources[i];
+        source.name = files[i].filename().string();
+
+        std::ifstream file(files[i], std::ios::binary);
+        std::stringstream data;
+        data << file.rdbuf();
+        source.contents = data.str();
+
+        std::string error;
+        if (!file || !parseLevel(source.contents, source.level, error))
+        {
+            std::cout << files[i].string() << ": " << (file ? error : "can't open file") << std::endl;
+            return 1;
+        }
+    }
+
+    std::string error;
+    if (!LevelBundle::write(argv[2], sources, error))
+    {
+        std::cout << error << std::endl;
+        return 1;
+    }
+
+    std::cout << "Bundled " << sources.size() << " levels into " << argv[2] << std::endl;
+    return 0;
+}
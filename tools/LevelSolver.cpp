@@ -0,0 +1,305 @@
+// Finds the shortest solution of a level file, or proves there is none.
+// Given a directory, checks every level in it on all cores and writes a json report.
+// Usage: OctopuzzlerSolver <level file or directory> [--max-nodes N] [--threads N] [--report file]
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include "Core/Simulation/Solver.h"
+#include "Core/ThreadPool.h"
+
+struct LevelReport
+{
+    std::string file;
+    std::string error; // empty if the level parsed
+
+    SolveResult result;
+    long long ms = 0;
+};
+
+static const char* controlName(Control control)
+{
+    switch (control)
+    {
+    case Control::MOVE_UP:    return "up";
+    case Control::MOVE_DOWN:  return "down";
+    case Control::MOVE_LEFT:  return "left";
+    case Control::MOVE_RIGHT: return "right";
+    case Control::DASH_UP:    return "dash up";
+    case Control::DASH_DOWN:  return "dash down";
+    case Control::DASH_LEFT:  return "dash left";
+    case Control::DASH_RIGHT: return "dash right";
+    default:                  return "none";
+    }
+}
+
+static const char* eyeName(Eye eye)
+{
+    switch (eye)
+    {
+    case Eye::CIRCLE:   return "circle";
+    case Eye::SQUARE:   return "square";
+    case Eye::TRIANGLE: return "triangle";
+    default:            return "none";
+    }
+}
+
+static const char* statusName(const LevelReport& report)
+{
+    if (!report.error.empty())
+        return "invalid";
+
+    switch (report.result.status)
+    {
+    case SolveStatus::SOLVED:     return "solved";
+    case SolveStatus::UNSOLVABLE: return "unsolvable";
+    default:                      return "gave_up";
+    }
+}
+
+static std::string stepText(const SolutionStep& step)
+{
+    if (step.type == SolutionStep::Type::BIND)
+        return std::string("bind ") + controlName(step.control) + " to " + eyeName(step.eye);
+
+    return std::string("poke ") + eyeName(step.eye);
+}
+
+static LevelReport checkLevel(const std::string& path, std::size_t maxNodes)
+{
+    LevelReport report;
+    report.file = path;
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        report.error = "can't open file";
+        return report;
+    }
+
+    std::stringstream levelData;
+    levelData << file.rdbuf();
+
+    Level level;
+    if (!parseLevel(levelData.str(), level, report.error))
+        return report;
+
+    auto begin = std::chrono::steady_clock::now();
+
+    Solver solver(Board::fromLevel(level), level.controls, maxNodes);
+    report.result = solver.solve();
+
+    report.ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - begin).count();
+
+    return report;
+}
+
+static int checkFile(const std::string& path, std::size_t maxNodes)
+{
+    LevelReport report = checkLevel(path, maxNodes);
+    const SolveResult& result = report.result;
+
+    std::cout << "level:    " << path << "\n";
+
+    if (!report.error.empty())
+    {
+        std::cout << "invalid:  " << report.error << std::endl;
+        return 2;
+    }
+
+    switch (result.status)
+    {
+    case SolveStatus::SOLVED:
+        std::cout << "solvable: yes\n"
+                  << "moves:    " << result.moves << "\n"
+                  << "solution:\n";
+
+        for (const SolutionStep& step : result.steps)
+            std::cout << "  " << stepText(step) << "\n";
+        break;
+
+    case SolveStatus::UNSOLVABLE:
+        std::cout << "solvable: no\n";
+        break;
+
+    case SolveStatus::GAVE_UP:
+        std::cout << "solvable: unknown (hit the limit of " << maxNodes << " nodes)\n";
+        break;
+    }
+
+    std::cout << "states:   " << result.statesExpanded << " in " << report.ms << " ms" << std::endl;
+
+    switch (result.status)
+    {
+    case SolveStatus::SOLVED:     return 0;
+    case SolveStatus::UNSOLVABLE: return 1;
+    default:                      return 2;
+    }
+}
+
+static int checkDirectory(const std::string& dir, std::size_t maxNodes, unsigned int threadCount, const std::string& reportPath)
+{
+    std::vector<std::string> files;
+
+    std::error_code ec;
+    for (auto it = std::filesystem::recursive_directory_iterator(dir, ec); !ec && it != std::filesystem::recursive_directory_iterator(); it.increment(ec))
+    {
+        if (it->is_regular_file())
+            files.emplace_back(it->path().generic_string());
+    }
+
+    if (ec)
+    {
+        std::cerr << "Can't read " << dir << ": " << ec.message() << std::endl;
+        return 2;
+    }
+
+    std::sort(files.begin(), files.end());
+
+    auto begin = std::chrono::steady_clock::now();
+
+    // every task writes its own slot, no locking needed
+    std::vector<LevelReport> reports(files.size());
+
+    {
+        ThreadPool pool(threadCount);
+
+        for (std::size_t i = 0; i < files.size(); i++)
+        {
+            pool.submit([&, i]
+            {
+                reports[i] = checkLevel(files[i], maxNodes);
+            });
+        }
+
+        pool.wait();
+    }
+
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - begin).count();
+
+    nlohmann::json levels = nlohmann::json::array();
+    nlohmann::json counts = { { "solved", 0 }, { "unsolvable", 0 }, { "gave_up", 0 }, { "invalid", 0 } };
+
+    for (const LevelReport& report : reports)
+    {
+        const char* status = statusName(report);
+        counts[status] = counts[status].get<int>() + 1;
+
+        nlohmann::json entry = { { "file", report.file }, { "status", status } };
+
+        if (!report.error.empty())
+        {
+            entry["error"] = report.error;
+        } else {
+            if (report.result.status == SolveStatus::SOLVED)
+            {
+                entry["moves"] = report.result.moves;
+
+                nlohmann::json solution = nlohmann::json::array();
+                for (const SolutionStep& step : report.result.steps)
+                    solution.push_back(stepText(step));
+
+                entry["solution"] = solution;
+            }
+
+            entry["states"] = report.result.statesExpanded;
+            entry["ms"] = report.ms;
+        }
+
+        levels.push_back(entry);
+    }
+
+    nlohmann::json json = {
+        { "directory", dir },
+        { "levels", levels },
+        { "counts", counts },
+        { "ms", ms }
+    };
+
+    if (reportPath.empty())
+    {
+        std::cout << json.dump(2) << std::endl;
+    } else {
+        std::ofstream out(reportPath);
+        if (!out)
+        {
+            std::cerr << "Can't write " << reportPath << "!" << std::endl;
+            return 2;
+        }
+
+        out << json.dump(2) << std::endl;
+    }
+
+    std::cerr << files.size() << " levels in " << ms << " ms: "
+              << counts["solved"] << " solved, " << counts["unsolvable"] << " unsolvable, "
+              << counts["gave_up"] << " gave up, " << counts["invalid"] << " invalid" << std::endl;
+
+    // anything that needs a human to look at it
+    return counts["solved"].get<std::size_t>() == files.size() ? 0 : 1;
+}
+
+static int usage(const char* program)
+{
+    std::cout << "Usage: " << program << " <level file or directory> [--max-nodes N] [--threads N] [--report file]" << std::endl;
+    return 2;
+}
+
+// the whole of text as a positive number, false for anything else
+template<typename T>
+static bool parseCount(const char* text, T& value)
+{
+    const char* end = text + strlen(text);
+    T parsed = 0;
+    const auto [ptr, ec] = std::from_chars(text, end, parsed);
+    if (ec != std::errc() || ptr != end || parsed == 0)
+        return false;
+
+    value = parsed;
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+        return usage(argv[0]);
+
+    std::size_t maxNodes = Solver::DEFAULT_MAX_NODES;
+    unsigned int threadCount = std::thread::hardware_concurrency();
+    std::string reportPath;
+
+    for (int i = 2; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--max-nodes") == 0 && i + 1 < argc)
+        {
+            if (!parseCount(argv[++i], maxNodes))
+            {
+                std::cout << "--max-nodes needs a positive number, not \"" << argv[i] << "\"!" << std::endl;
+                return usage(argv[0]);
+            }
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+        {
+            if (!parseCount(argv[++i], threadCount))
+            {
+                std::cout << "--threads needs a positive number, not \"" << argv[i] << "\"!" << std::endl;
+                return usage(argv[0]);
+            }
+        } else if (strcmp(argv[i], "--report") == 0 && i + 1 < argc)
+        {
+            reportPath = argv[++i];
+        } else {
+            std::cout << "Unknown argument \"" << argv[i] << "\"!" << std::endl;
+            return 2;
+        }
+    }
+
+    if (std::filesystem::is_directory(argv[1]))
+        return checkDirectory(argv[1], maxNodes, threadCount, reportPath);
+
+    return checkFile(argv[1], maxNodes);
+}
@@ -0,0 +1,64 @@
+// Packs a whole folder into one pak the game mounts at startup, LZ4 compressing the files it helps with.
+// Usage: OctopuzzlerPak <folder> <output.pak> [--no-compress]
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+#include "Core/Pak.h"
+
+int main(int argc, char** argv)
+{
+    if (argc < 3 || argc > 4 || (argc == 4 && strcmp(argv[3], "--no-compress") != 0))
+    {
+        std::cout << "Usage: " << argv[0] << " <folder> <output.pak> [--no-compress]" << std::endl;
+        return 2;
+    }
+
+    const std::filesystem::path root = argv[1];
+    const bool compress = argc != 4;
+
+    std::vector<Pak::Source> sources;
+    std::size_t totalSize = 0;
+
+    std::error_code ec;
+    for (auto it = std::filesystem::recursive_directory_iterator(root, ec); !ec && it != std::filesystem::recursive_directory_iterator(); it.increment(ec))
+    {
+        if (!it->is_regular_file())
+            continue;
+
+        Pak::Source& source = sources.emplace_back();
+        source.path = it->path().lexically_relative(root).generic_string();
+
+        std::ifstream file(it->path(), std::ios::binary);
+        source.data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+        if (!file && !file.eof())
+        {
+            std::cout << "Can't read " << it->path().string() << std::endl;
+            return 1;
+        }
+
+        totalSize += source.data.size();
+    }
+
+    if (ec)
+    {
+        std::cout << "Can't read " << root.string() << ": " << ec.message() << std::endl;
+        return 2;
+    }
+
+    const std::size_t fileCount = sources.size();
+
+    std::string error;
+    if (!Pak::write(argv[2], std::move(sources), compress, error))
+    {
+        std::cout << error << std::endl;
+        return 1;
+    }
+
+    std::cout << "Packed " << fileCount << " files (" << totalSize / 1024 << " KB) into " << argv[2]
+              << " (" << std::filesystem::file_size(argv[2]) / 1024 << " KB)" << std::endl;
+    return 0;
+}